@@ -0,0 +1,82 @@
+#ifndef BENCH_ROUTINE_H_
+#define BENCH_ROUTINE_H_
+#include <Arduino.h>
+
+// Hooks of the latency/throughput benchmark for the "set message -> relay GPIO write -> report publish"
+// path. Every command is stamped on arrival, on the GPIO write and on the report publish, so the
+// queueing and report coalescing delays (REPORT_COALESCE_MS) are included.
+// The benchmark itself runs the sketch on the host, see test/host/bench_main.cpp, it never switches
+// a real relay. NR_BENCHMARK is set by the host build only, otherwise all hooks compile to nothing.
+
+#ifndef NR_BENCHMARK
+#define NR_BENCHMARK false
+#endif
+
+typedef struct {
+    uint32_t ulCount;
+    uint32_t ulMin;
+    uint32_t ulMax;
+    uint64_t ullSum;
+} bench_stat_t;
+
+typedef struct {
+    bench_stat_t xRxToActuate;      // us, message arrival -> relay GPIO write
+    bench_stat_t xRxToPublish;      // us, message arrival -> report handed to mqttClient
+} bench_live_t;
+
+#if NR_BENCHMARK
+
+bench_live_t xBenchLive;
+
+uint32_t ulBenchRxAt = 0;
+uint32_t ulBenchActuatedAt = 0;
+bool bBenchPending = false;
+uint32_t ulBenchHeapLow = 0;
+
+void vBenchStatAdd(bench_stat_t * pxStat, uint32_t ulValue) {
+    if (pxStat->ulCount == 0 || ulValue < pxStat->ulMin) pxStat->ulMin = ulValue;
+    if (ulValue > pxStat->ulMax) pxStat->ulMax = ulValue;
+    pxStat->ullSum += ulValue;
+    pxStat->ulCount++;
+}
+
+uint32_t ulBenchStatAvg(const bench_stat_t * pxStat) {
+    return pxStat->ulCount ? (uint32_t)(pxStat->ullSum / pxStat->ulCount) : 0;
+}
+
+void vBenchSampleHeap() {
+    uint32_t ulFree = ESP.getFreeHeap();
+    if (ulFree < ulBenchHeapLow) ulBenchHeapLow = ulFree;
+}
+
+// Hooks, called from the hot path
+void vBenchOnMessage() {
+    if (bBenchPending) return;      // previous command still in flight, keep measuring it
+    ulBenchRxAt = micros();
+    ulBenchActuatedAt = 0;
+    bBenchPending = true;
+}
+
+void vBenchOnActuate() {
+    vBenchSampleHeap();
+    if (!bBenchPending || ulBenchActuatedAt != 0) return;
+    ulBenchActuatedAt = micros();
+    vBenchStatAdd(&xBenchLive.xRxToActuate, ulBenchActuatedAt - ulBenchRxAt);
+}
+
+void vBenchOnPublish() {
+    vBenchSampleHeap();
+    if (!bBenchPending || ulBenchActuatedAt == 0) return;
+    vBenchStatAdd(&xBenchLive.xRxToPublish, micros() - ulBenchRxAt);
+    bBenchPending = false;
+}
+
+#else
+
+inline void vBenchOnMessage() {}
+inline void vBenchOnActuate() {}
+inline void vBenchOnPublish() {}
+
+#endif  // NR_BENCHMARK
+
+#endif  // BENCH_ROUTINE_H_
@@ -0,0 +1,92 @@
+#ifndef BINARY_PROTOCOL_H_
+#define BINARY_PROTOCOL_H_
+#include <Arduino.h>
+
+// Compact binary command/state frames for NR_MQTT_BIN_SET_TOPIC / NR_MQTT_BIN_REPORT_TOPIC.
+// All multibyte fields are little endian. Bit N of a mask is relay N+1.
+//
+// Command frame, 10 bytes:
+//   [0]     BIN_FRAME_COMMAND
+//   [1]     flags, BIN_FLAG_STATUS asks for a state frame even if no relay is addressed
+//   [2..3]  sequence number, echoed back in the state frame
+//   [4..5]  relay mask: relays the command applies to
+//   [6..7]  toggle mask: addressed relays to toggle
+//   [8..9]  state mask: addressed relays not toggled are set ON (1) or OFF (0)
+//
+// State frame, 12 bytes:
+//   [0]     BIN_FRAME_STATE
+//   [1]     flags, BIN_FLAG_EXTERNAL_CONTROL when pings are coming
+//   [2..3]  sequence number of the last executed command
+//   [4]     relays count
+//   [5]     exit code
+//   [6..7]  state mask, 1 = ON
+//   [8..11] uptime, ms
+
+#ifndef NR_MQTT_BINARY
+#define NR_MQTT_BINARY false
+#endif
+#ifndef NR_MQTT_BIN_SET_TOPIC
+#define NR_MQTT_BIN_SET_TOPIC NR_MQTT_SET_TOPIC "/bin"
+#endif
+#ifndef NR_MQTT_BIN_REPORT_TOPIC
+#define NR_MQTT_BIN_REPORT_TOPIC NR_MQTT_REPORT_TOPIC "/bin"
+#endif
+
+#define BIN_FRAME_COMMAND   0x01
+#define BIN_FRAME_STATE     0x81
+
+#define BIN_FLAG_STATUS             BIT0
+#define BIN_FLAG_EXTERNAL_CONTROL   BIT0
+
+#define BIN_COMMAND_LEN     10
+#define BIN_STATE_LEN       12
+
+typedef struct {
+    uint8_t uiFlags;
+    uint16_t uiSeq;
+    uint16_t uiRelayMask;
+    uint16_t uiToggleMask;
+    uint16_t uiStateMask;
+} bin_command_t;
+
+typedef struct {
+    uint8_t uiFlags;
+    uint16_t uiSeq;
+    uint8_t uiRelaysCount;
+    uint8_t uiExitCode;
+    uint16_t uiStateMask;
+    uint32_t ulUptimeMs;
+} bin_state_t;
+
+uint16_t uiBinGet16(const uint8_t * pc) {
+    return pc[0] | (pc[1] << 8);
+}
+
+void vBinPut16(uint8_t * pc, uint16_t uiValue) {
+    pc[0] = uiValue & 0xFF;
+    pc[1] = uiValue >> 8;
+}
+
+bool bBinDecodeCommand(const uint8_t * pcFrame, size_t len, bin_command_t * pxCmd) {
+    if (len != BIN_COMMAND_LEN || pcFrame[0] != BIN_FRAME_COMMAND) return false;
+    pxCmd->uiFlags = pcFrame[1];
+    pxCmd->uiSeq = uiBinGet16(pcFrame + 2);
+    pxCmd->uiRelayMask = uiBinGet16(pcFrame + 4);
+    pxCmd->uiToggleMask = uiBinGet16(pcFrame + 6);
+    pxCmd->uiStateMask = uiBinGet16(pcFrame + 8);
+    return true;
+}
+
+size_t uiBinEncodeState(uint8_t * pcFrame, const bin_state_t * pxState) {
+    pcFrame[0] = BIN_FRAME_STATE;
+    pcFrame[1] = pxState->uiFlags;
+    vBinPut16(pcFrame + 2, pxState->uiSeq);
+    pcFrame[4] = pxState->uiRelaysCount;
+    pcFrame[5] = pxState->uiExitCode;
+    vBinPut16(pcFrame + 6, pxState->uiStateMask);
+    vBinPut16(pcFrame + 8, pxState->ulUptimeMs & 0xFFFF);
+    vBinPut16(pcFrame + 10, pxState->ulUptimeMs >> 16);
+    return BIN_STATE_LEN;
+}
+
+#endif  // BINARY_PROTOCOL_H_
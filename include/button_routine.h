@@ -0,0 +1,171 @@
+#ifndef BUTTON_ROUTINE_H_
+#define BUTTON_ROUTINE_H_
+#include <Arduino.h>
+#include <coredecls.h>
+extern "C" {
+#include <gpio.h>
+}
+
+// Interrupt driven buttons. The ISR only stamps the last edge, everything else
+// (debounce and gesture recognition) is done by vButtonsHandler() from loop(),
+// and only while some button has a pending edge or an unfinished gesture.
+// In light sleep the pins are switched to low level wakeup (vButtonsWakeArm), the first
+// interrupt switches them all back to edges, a held button would fire a level interrupt forever.
+
+#ifndef BUTTON_DEBOUNCE_MS
+#define BUTTON_DEBOUNCE_MS      5
+#endif
+#ifndef BUTTON_DOUBLE_CLICK_MS
+#define BUTTON_DOUBLE_CLICK_MS  300
+#endif
+#ifndef BUTTON_LONG_PRESS_MS
+#define BUTTON_LONG_PRESS_MS    800
+#endif
+#ifndef BUTTON_REPEAT_MS
+#define BUTTON_REPEAT_MS        250
+#endif
+
+#define BUTTON_STATE_PUSH       LOW
+#define BUTTON_STATE_RELEASE    HIGH
+
+typedef enum {
+    BTN_GESTURE_NONE = 0,
+    BTN_GESTURE_SINGLE,
+    BTN_GESTURE_DOUBLE,
+    BTN_GESTURE_LONG,
+    BTN_GESTURE_HOLD_REPEAT,
+    BTN_GESTURES_COUNT
+} button_gesture_t;
+
+const char * const pcButtonGestureNames[BTN_GESTURES_COUNT] = { "none", "single", "double", "long", "hold" };
+
+typedef struct {
+    uint8_t uiPin;
+    uint8_t uiState;
+    volatile bool bEdge;
+    volatile uint32_t ulEdgeAt;
+    uint32_t ulChangedAt;
+    uint32_t ulPrevStateDuration;
+    uint32_t ulRepeatAt;
+    uint8_t uiClicks;
+    bool bLongFired;
+    bool bDoubleEnabled;    // false: single click fires right on press, no waiting for the second one
+} button_t;
+
+typedef void (*vButtonGestureCB_t)(uint8_t uiButtonIdx, button_gesture_t xGesture);
+
+button_t * pxButtonsAll = NULL;
+uint8_t uiButtonsAll = 0;
+volatile bool bButtonsWakeArmed = false;
+
+// Registers only, runs in the ISR
+void IRAM_ATTR vButtonsWakeDisarm() {
+    for (uint8_t i = 0; i < uiButtonsAll; i++) {
+        uint8_t uiPin = pxButtonsAll[i].uiPin;
+        GPC(uiPin) = (GPC(uiPin) & ~((7 << GPCI) | (1 << GPCWE))) | (CHANGE << GPCI);
+    }
+    bButtonsWakeArmed = false;
+}
+
+// Only when no button is pressed, see above
+void vButtonsWakeArm() {
+    for (uint8_t i = 0; i < uiButtonsAll; i++) gpio_pin_wakeup_enable(GPIO_ID_PIN(pxButtonsAll[i].uiPin), GPIO_PIN_INTR_LOLEVEL);
+    bButtonsWakeArmed = true;
+}
+
+void IRAM_ATTR vButtonISR(void * pvArg) {
+    button_t * pxButton = (button_t *)pvArg;
+    pxButton->ulEdgeAt = millis();
+    pxButton->bEdge = true;
+    if (bButtonsWakeArmed) vButtonsWakeDisarm();
+    esp_schedule();     // loop() may be idling, see power_policy.h
+}
+
+void vButtonsBegin(button_t * pxButtons, uint8_t uiCount) {
+    pxButtonsAll = pxButtons;
+    uiButtonsAll = uiCount;
+    for (uint8_t i = 0; i < uiCount; i++) {
+        pinMode(pxButtons[i].uiPin, INPUT_PULLUP);
+        pxButtons[i].uiState = digitalRead(pxButtons[i].uiPin);
+        pxButtons[i].ulChangedAt = millis();
+        attachInterruptArg(digitalPinToInterrupt(pxButtons[i].uiPin), vButtonISR, &pxButtons[i], CHANGE);
+    }
+}
+
+bool bButtonActive(const button_t * pxButton) {
+    return pxButton->bEdge || pxButton->uiState == BUTTON_STATE_PUSH || pxButton->uiClicks > 0;
+}
+
+bool bButtonsActive(const button_t * pxButtons, uint8_t uiCount) {
+    for (uint8_t i = 0; i < uiCount; i++) {
+        if (bButtonActive(&pxButtons[i])) return true;
+    }
+    return false;
+}
+
+void vButtonOnChange(button_t * pxButton, uint8_t uiIdx, uint32_t ulAt, vButtonGestureCB_t pvGestureCB) {
+    pxButton->ulPrevStateDuration = ulAt - pxButton->ulChangedAt;
+    pxButton->ulChangedAt = ulAt;
+
+    if (pxButton->uiState == BUTTON_STATE_PUSH) {
+        pxButton->bLongFired = false;
+        if (!pxButton->bDoubleEnabled) {
+            pvGestureCB(uiIdx, BTN_GESTURE_SINGLE);
+            return;
+        }
+        pxButton->uiClicks++;
+        return;
+    }
+
+    // released
+    if (pxButton->bLongFired) {
+        pxButton->uiClicks = 0;
+        return;
+    }
+    if (pxButton->ulPrevStateDuration >= BUTTON_LONG_PRESS_MS) {    // handler was late, the press is still long
+        pxButton->uiClicks = 0;
+        pvGestureCB(uiIdx, BTN_GESTURE_LONG);
+        return;
+    }
+    if (pxButton->uiClicks >= 2) {
+        pxButton->uiClicks = 0;
+        pvGestureCB(uiIdx, BTN_GESTURE_DOUBLE);
+    }
+}
+
+void vButtonsHandler(button_t * pxButtons, uint8_t uiCount, vButtonGestureCB_t pvGestureCB) {
+    uint32_t ulNow = millis();
+    for (uint8_t i = 0; i < uiCount; i++) {
+        button_t * pxButton = &pxButtons[i];
+        if (!bButtonActive(pxButton)) continue;
+
+        if (pxButton->bEdge && ulNow - pxButton->ulEdgeAt >= BUTTON_DEBOUNCE_MS) {
+            uint32_t ulEdgeAt = pxButton->ulEdgeAt;
+            pxButton->bEdge = false;    // an edge after this point will be picked up on the next pass
+            uint8_t uiRead = digitalRead(pxButton->uiPin);
+            if (uiRead != pxButton->uiState) {
+                pxButton->uiState = uiRead;
+                vButtonOnChange(pxButton, i, ulEdgeAt, pvGestureCB);
+            }
+        }
+        if (pxButton->bEdge) continue;  // still bouncing
+
+        uint32_t ulElapsed = ulNow - pxButton->ulChangedAt;
+        if (pxButton->uiState == BUTTON_STATE_PUSH) {
+            if (!pxButton->bLongFired && ulElapsed >= BUTTON_LONG_PRESS_MS) {
+                pxButton->bLongFired = true;
+                pxButton->uiClicks = 0;
+                pxButton->ulRepeatAt = ulNow + BUTTON_REPEAT_MS;
+                pvGestureCB(i, BTN_GESTURE_LONG);
+            } else if (pxButton->bLongFired && (int32_t)(ulNow - pxButton->ulRepeatAt) >= 0) {
+                pxButton->ulRepeatAt += BUTTON_REPEAT_MS;
+                pvGestureCB(i, BTN_GESTURE_HOLD_REPEAT);
+            }
+        } else if (pxButton->uiClicks == 1 && ulElapsed >= BUTTON_DOUBLE_CLICK_MS) {
+            pxButton->uiClicks = 0;
+            pvGestureCB(i, BTN_GESTURE_SINGLE);
+        }
+    }
+}
+
+#endif  // BUTTON_ROUTINE_H_
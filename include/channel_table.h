@@ -0,0 +1,53 @@
+#ifndef CHANNEL_TABLE_H_
+#define CHANNEL_TABLE_H_
+#include <Arduino.h>
+
+// Everything per channel (relay + button) is generated from one list in the sketch:
+//
+//   #define CHANNELS(X)  X(1, PIN_RELAY1, PIN_BTN1) X(2, PIN_RELAY2, PIN_BTN2) ...
+//
+// Channels are numbered from 1, in order. CHANNELS(CHANNEL_ENTRY) expands the list into
+// a constexpr channel_t table with the pins, JSON keys and topics as string literals,
+// CHANNELS_COUNT is a constant, so nothing is formatted at run time and every per-channel
+// loop has a compile-time bound. vChannelsUnroll<N>() unrolls the hot ones completely.
+
+#ifndef NR_MQTT_CHANNEL_TOPIC
+#define NR_MQTT_CHANNEL_TOPIC   NR_MQTT_REPORT_TOPIC "/l"   // + "1/set", + "1" for the retained state
+#endif
+
+#define CHANNELS_MAX    16      // relay masks are 16 bit
+
+typedef struct {
+    uint8_t uiRelayPin;
+    uint8_t uiButtonPin;
+    const char * pcStateKey;    // "l1_state"
+    const char * pcAutoOffKey;  // "l1_autooff"
+    const char * pcSetTopic;    // NR_MQTT_CHANNEL_TOPIC "1/set"
+    const char * pcStateTopic;  // NR_MQTT_CHANNEL_TOPIC "1"
+} channel_t;
+
+#define CHANNEL_ENTRY(n, relay, button)     { relay, button, "l" #n "_state", "l" #n "_autooff", NR_MQTT_CHANNEL_TOPIC #n "/set", NR_MQTT_CHANNEL_TOPIC #n },
+#define CHANNEL_COUNT_ONE(n, relay, button) + 1
+#define CHANNELS_COUNT                      (0 CHANNELS(CHANNEL_COUNT_ONE))
+
+// vChannelsUnroll<CHANNELS_COUNT>(f) calls f(0), f(1), ... f(N-1) without a loop,
+// with f inlined every index is a constant and the table lookups fold away
+template <uint8_t I, uint8_t N>
+struct channels_unroll_t {
+    template <typename F> static inline void vRun(F & f) {
+        f(I);
+        channels_unroll_t<I + 1, N>::vRun(f);
+    }
+};
+
+template <uint8_t N>
+struct channels_unroll_t<N, N> {
+    template <typename F> static inline void vRun(F &) {}
+};
+
+template <uint8_t N, typename F>
+inline void vChannelsUnroll(F f) {
+    channels_unroll_t<0, N>::vRun(f);
+}
+
+#endif  // CHANNEL_TABLE_H_
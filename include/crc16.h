@@ -0,0 +1,15 @@
+#ifndef CRC16_H_
+#define CRC16_H_
+#include <Arduino.h>
+
+// CRC-16/CCITT-FALSE, bitwise: the records it guards are a few dozen bytes
+uint16_t uiCrc16(const void * pvData, size_t len, uint16_t uiCrc = 0xFFFF) {
+    const uint8_t * pc = (const uint8_t *)pvData;
+    while (len--) {
+        uiCrc ^= (uint16_t)*pc++ << 8;
+        for (uint8_t i = 0; i < 8; i++) uiCrc = (uiCrc & 0x8000) ? (uiCrc << 1) ^ 0x1021 : uiCrc << 1;
+    }
+    return uiCrc;
+}
+
+#endif  // CRC16_H_
@@ -11,7 +11,21 @@
 #define NR_MQTT_REPORT_TOPIC "myhome/sonoff"
 #define NR_MQTT_SET_TOPIC "myhome/sonoff/set"
 #define NR_MQTT_PING_TOPIC "myhome/sonoff/ping"
+#define NR_MQTT_CHANNEL_TOPICS  true                  // raw ON/OFF/TOGGLE on myhome/sonoff/l1/set etc.
+#define NR_MQTT_CHANNEL_TOPIC   "myhome/sonoff/l"
 #define NR_DEVICE_ALIAS "SonOff_T3"
+#define MQTT_MESSAGE_MAX_LEN    1024        // longer messages are dropped, see mqtt_reassembly.h
+
+// Binary command/state frames next to the JSON ones, see binary_protocol.h
+#define NR_MQTT_BINARY            false
+#define NR_MQTT_BIN_SET_TOPIC     "myhome/sonoff/set/bin"
+#define NR_MQTT_BIN_REPORT_TOPIC  "myhome/sonoff/bin"
+
+// Scenes for the whole fleet on one shared topic, see group_control.h
+#define NR_MQTT_GROUP             false
+#define NR_MQTT_GROUP_TOPIC       "myhome/group/set"
+#define NR_GROUP_DEVICE_INDEX     0         // bit in the device bitmap, unique in the fleet
+#define NR_GROUP_MASK             0x00000001UL  // group IDs this device is in, bit G = group G
 
 
 #define NR_SSID ""
@@ -22,9 +36,52 @@
 #define NR_MQTT_SERVER_URL ""
 #define NR_MQTT_SERVER_PORT 1883
 
+// Persistent session, LWT availability and retained per-channel state, see net_routine.h
+#define NR_MQTT_PERSISTENT        true
+#define NR_MQTT_CLIENT_ID         ""        // "": derived from the chip ID
+#define NR_MQTT_AVAIL_TOPIC       "myhome/sonoff/status"
+
 #define WAIT_FOR_PING_SECS      600
 #define IM_ALONE_TIMEOUT_MS  600 * 1000
-#define READ_BUTTONS_HANDLER_PERIOD_MS 60
-#define REPORT_HANDLER_IDLE_MS    50
-#define REPORT_HANDLER_SEND_MS    500
+#define BUTTON_DEBOUNCE_MS        5
+#define BUTTON_DOUBLE_CLICK_MS    300
+#define BUTTON_LONG_PRESS_MS      800
+#define BUTTON_REPEAT_MS          250
+#define REPORT_COALESCE_MS        250
+#define REPORT_MAX_INFLIGHT       4
+#define REPORT_ACK_TIMEOUT_MS     10000
+#define NR_JOURNAL_RTC            true    // keep the offline journal in RTC memory across resets
+#define NR_FLASH_STORE            true    // relay states, settings and schedule in flash, needs an 8 KB+ filesystem area (eagle.flash.1m64.ld)
+#define FLASH_STORE_COALESCE_MS   2000
 #define SCHEDULE_TASK_DELAY_MS    5000
+
+// Local relay schedule uploaded to NR_MQTT_SCHEDULE_TOPIC, see schedule_engine.h
+#define NR_SCHEDULE               true
+#define NR_MQTT_SCHEDULE_TOPIC    "myhome/sonoff/set/schedule"
+
+// Serial log, see log_routine.h. LOG_LEVEL_NONE/ERROR/WARN/INFO/DEBUG, the ones above are not compiled in
+#define NR_LOG_LEVEL              LOG_LEVEL_INFO
+
+// Pull OTA over HTTP with resume, heatshrink or gzip images, see ota_routine.h
+#define NR_OTA_HTTP               false
+#define NR_MQTT_OTA_TOPIC         "myhome/sonoff/set/ota"
+#define NR_OTA_PUBLIC_KEY         ""        // PEM of the image signing key, "-----BEGIN PUBLIC KEY-----\n..." (checked at build time)
+
+// Direct LAN control over UDP, HMAC authenticated, see lan_control.h
+#define NR_LAN_CONTROL            false
+#define NR_LAN_UDP_PORT           4210
+#define NR_LAN_KEY                ""        // shared secret, random, 16 characters or more (checked at build time)
+
+// Modem and light sleep while idle, buttons wake over GPIO, see power_policy.h. "POWER" command reports it
+#define NR_POWER_POLICY           false
+#define POWER_MODEM_AFTER_MS      2000
+#define POWER_LIGHT_AFTER_MS      30000
+#define POWER_LISTEN_INTERVAL     3
+
+// Handler timing and heap counters, returned by "STATS" command, see profiler.h
+#define NR_PROFILER               true
+
+// Broker RTT, command and PUBACK latency histograms, returned by "LATENCY" command, see latency_stats.h
+#define NR_LATENCY_STATS          true
+#define NR_MQTT_RTT_TOPIC         "myhome/sonoff/rtt"
+#define RTT_PROBE_INTERVAL_MS     30000
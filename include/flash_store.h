@@ -0,0 +1,187 @@
+#ifndef FLASH_STORE_H_
+#define FLASH_STORE_H_
+#include <Arduino.h>
+#include <crc16.h>
+
+// Small log-structured key/value store on two flash sectors at the start of the filesystem area.
+// It holds everything that must survive a power cycle: relay states, auto-off times, the schedule.
+// The firmware uses no filesystem, but the ld script has to reserve 8 KB or more for one. The 1 MB
+// Sonoff layouts without it (eagle.flash.1m.ld) leave no room, build with eagle.flash.1m64.ld or
+// another one with a filesystem. Without room the store stays off, which the first DEVINFO report
+// after boot shows as "flash_store":0.
+// The RTC session (net_session.h) is not a store: it only bridges a reset, during which this one
+// may still be up to FLASH_STORE_COALESCE_MS behind.
+//  - sector: { FLASH_STORE_MAGIC, generation } then records, the valid sector with the newest
+//    generation is the active one;
+//  - record: one word { key, len, crc16 } and the value padded to 4 bytes, appended to the active
+//    sector, so a value change costs one small write and no erase;
+//  - a full sector is compacted: the other one is erased, gets the latest value of every key and
+//    its header last, so a power loss in the middle leaves the old sector in charge;
+//  - boot scans the active sector into RAM, stopping at the first erased word or bad CRC
+//    (a torn write, the sector is compacted right away).
+// vFlashStorePut() only changes the RAM copy, vFlashStoreHandler() writes what changed
+// once nothing changed for FLASH_STORE_COALESCE_MS, so a burst of switching is one record.
+
+#ifndef NR_FLASH_STORE
+#define NR_FLASH_STORE true
+#endif
+#ifndef FLASH_STORE_COALESCE_MS
+#define FLASH_STORE_COALESCE_MS 2000
+#endif
+
+#define FLASH_STORE_KEYS        4
+#define FLASH_STORE_VALUE_MAX   136     // a whole schedule table
+#define FLASH_STORE_MAGIC       0x474F4C46UL    // "FLOG"
+#define FLASH_STORE_HEADER_LEN  8
+
+typedef struct {
+    uint32_t ulBase;            // flash address of the first sector, 0 = no room for the store
+    uint8_t uiActive;           // 0 or 1
+    uint32_t ulGeneration;
+    uint16_t uiWriteOffset;     // in the active sector
+    uint32_t pulValues[FLASH_STORE_KEYS][FLASH_STORE_VALUE_MAX / 4];
+    uint8_t uiLens[FLASH_STORE_KEYS];   // 0 = never set
+    uint8_t uiDirty;
+    uint32_t ulChangedAt;
+    uint32_t ulRecords;
+    uint32_t ulCompactions;
+} flash_store_t;
+
+uint32_t ulFlashStoreSector(const flash_store_t * pxStore, uint8_t uiSector) {
+    return pxStore->ulBase + uiSector * SPI_FLASH_SEC_SIZE;
+}
+
+uint16_t uiFlashStoreCrc(uint32_t ulHeader, const void * pvValue, uint8_t uiLen) {
+    uint8_t pcKeyLen[2] = { (uint8_t)(ulHeader & 0xFF), (uint8_t)((ulHeader >> 8) & 0xFF) };
+    return uiCrc16(pvValue, uiLen, uiCrc16(pcKeyLen, sizeof(pcKeyLen)));
+}
+
+bool bFlashStoreWriteRecord(flash_store_t * pxStore, uint8_t uiSector, uint16_t * puiOffset, uint8_t uiKey) {
+    uint8_t uiLen = pxStore->uiLens[uiKey];
+    uint16_t uiPadded = (uiLen + 3) & ~3;
+    uint32_t pulRecord[1 + FLASH_STORE_VALUE_MAX / 4];
+    memset(pulRecord, 0xFF, sizeof(pulRecord));
+    pulRecord[0] = uiKey | (uint32_t)uiLen << 8;
+    pulRecord[0] |= (uint32_t)uiFlashStoreCrc(pulRecord[0], pxStore->pulValues[uiKey], uiLen) << 16;
+    memcpy(&pulRecord[1], pxStore->pulValues[uiKey], uiLen);
+    if (spi_flash_write(ulFlashStoreSector(pxStore, uiSector) + *puiOffset, pulRecord, 4 + uiPadded) != SPI_FLASH_RESULT_OK) return false;
+    *puiOffset += 4 + uiPadded;
+    pxStore->ulRecords++;
+    return true;
+}
+
+// Moves the latest values into the other sector
+bool bFlashStoreCompact(flash_store_t * pxStore) {
+    uint8_t uiTarget = !pxStore->uiActive;
+    uint32_t ulAddr = ulFlashStoreSector(pxStore, uiTarget);
+    if (spi_flash_erase_sector(ulAddr / SPI_FLASH_SEC_SIZE) != SPI_FLASH_RESULT_OK) return false;
+    uint16_t uiOffset = FLASH_STORE_HEADER_LEN;
+    for (uint8_t uiKey = 0; uiKey < FLASH_STORE_KEYS; uiKey++) {
+        if (pxStore->uiLens[uiKey] && !bFlashStoreWriteRecord(pxStore, uiTarget, &uiOffset, uiKey)) return false;
+    }
+    uint32_t pulHeader[2] = { FLASH_STORE_MAGIC, pxStore->ulGeneration + 1 };
+    if (spi_flash_write(ulAddr, pulHeader, sizeof(pulHeader)) != SPI_FLASH_RESULT_OK) return false;
+    pxStore->uiActive = uiTarget;
+    pxStore->ulGeneration++;
+    pxStore->uiWriteOffset = uiOffset;
+    pxStore->uiDirty = 0;
+    pxStore->ulCompactions++;
+    return true;
+}
+
+// Reads the active sector into RAM. false if there is no room for the store.
+bool bFlashStoreBegin(flash_store_t * pxStore) {
+    memset(pxStore, 0, sizeof(flash_store_t));
+    uint32_t ulStart = (uint32_t)(uintptr_t)&_FS_start - 0x40200000;
+    uint32_t ulEnd = (uint32_t)(uintptr_t)&_FS_end - 0x40200000;
+    if (ulEnd <= ulStart || ulEnd - ulStart < 2 * SPI_FLASH_SEC_SIZE) return false;
+    pxStore->ulBase = ulStart;
+
+    uint32_t pulHeaders[2][2];
+    for (uint8_t i = 0; i < 2; i++) {
+        spi_flash_read(ulFlashStoreSector(pxStore, i), pulHeaders[i], sizeof(pulHeaders[i]));
+    }
+    bool bValid0 = pulHeaders[0][0] == FLASH_STORE_MAGIC;
+    bool bValid1 = pulHeaders[1][0] == FLASH_STORE_MAGIC;
+    if (!bValid0 && !bValid1) {     // first run: start with sector 1, compaction makes 0 active
+        pxStore->uiActive = 1;
+        return bFlashStoreCompact(pxStore);
+    }
+    pxStore->uiActive = (bValid1 && (!bValid0 || (int32_t)(pulHeaders[1][1] - pulHeaders[0][1]) > 0)) ? 1 : 0;
+    pxStore->ulGeneration = pulHeaders[pxStore->uiActive][1];
+
+    uint32_t ulAddr = ulFlashStoreSector(pxStore, pxStore->uiActive);
+    uint16_t uiOffset = FLASH_STORE_HEADER_LEN;
+    bool bTorn = false;
+    while (uiOffset + 4 <= SPI_FLASH_SEC_SIZE) {
+        uint32_t ulHeader;
+        spi_flash_read(ulAddr + uiOffset, &ulHeader, sizeof(ulHeader));
+        if (ulHeader == 0xFFFFFFFF) break;
+        uint8_t uiKey = ulHeader & 0xFF;
+        uint8_t uiLen = (ulHeader >> 8) & 0xFF;
+        uint16_t uiPadded = (uiLen + 3) & ~3;
+        uint32_t pulValue[FLASH_STORE_VALUE_MAX / 4];
+        if (uiKey >= FLASH_STORE_KEYS || uiLen == 0 || uiLen > FLASH_STORE_VALUE_MAX || uiOffset + 4 + uiPadded > SPI_FLASH_SEC_SIZE) {
+            bTorn = true;
+            break;
+        }
+        spi_flash_read(ulAddr + uiOffset + 4, pulValue, uiPadded);
+        if (uiFlashStoreCrc(ulHeader, pulValue, uiLen) != (ulHeader >> 16)) {
+            bTorn = true;
+            break;
+        }
+        memcpy(pxStore->pulValues[uiKey], pulValue, uiLen);
+        pxStore->uiLens[uiKey] = uiLen;
+        uiOffset += 4 + uiPadded;
+    }
+    pxStore->uiWriteOffset = uiOffset;
+    if (bTorn && !bFlashStoreCompact(pxStore)) {
+        pxStore->ulBase = 0;    // nowhere safe to append, values read so far are still there
+        return false;
+    }
+    return true;
+}
+
+// Copies the value out, false if it was never set or has another size
+bool bFlashStoreGet(const flash_store_t * pxStore, uint8_t uiKey, void * pvValue, uint8_t uiLen) {
+    if (uiKey >= FLASH_STORE_KEYS || pxStore->uiLens[uiKey] != uiLen) return false;
+    memcpy(pvValue, pxStore->pulValues[uiKey], uiLen);
+    return true;
+}
+
+// RAM only, safe from SYS callbacks
+void vFlashStorePut(flash_store_t * pxStore, uint8_t uiKey, const void * pvValue, uint8_t uiLen) {
+    if (!pxStore->ulBase || uiKey >= FLASH_STORE_KEYS || uiLen == 0 || uiLen > FLASH_STORE_VALUE_MAX) return;
+    if (pxStore->uiLens[uiKey] == uiLen && memcmp(pxStore->pulValues[uiKey], pvValue, uiLen) == 0) return;
+    memcpy(pxStore->pulValues[uiKey], pvValue, uiLen);
+    pxStore->uiLens[uiKey] = uiLen;
+    pxStore->uiDirty |= 1 << uiKey;
+    pxStore->ulChangedAt = millis();
+}
+
+// Writes every changed value now. On a flash error it is tried again FLASH_STORE_COALESCE_MS later.
+void vFlashStoreFlush(flash_store_t * pxStore) {
+    if (!pxStore->ulBase) return;
+    for (uint8_t uiKey = 0; uiKey < FLASH_STORE_KEYS && pxStore->uiDirty; uiKey++) {
+        if (!(pxStore->uiDirty & (1 << uiKey))) continue;
+        bool bOk;
+        if (pxStore->uiWriteOffset + 4 + ((pxStore->uiLens[uiKey] + 3) & ~3) > SPI_FLASH_SEC_SIZE) {
+            bOk = bFlashStoreCompact(pxStore);  // takes every dirty value along
+        } else {
+            bOk = bFlashStoreWriteRecord(pxStore, pxStore->uiActive, &pxStore->uiWriteOffset, uiKey);
+            if (bOk) pxStore->uiDirty &= ~(1 << uiKey);
+        }
+        if (!bOk) {
+            pxStore->ulChangedAt = millis();
+            return;
+        }
+    }
+}
+
+// Called from loop()
+void vFlashStoreHandler(flash_store_t * pxStore) {
+    if (!pxStore->uiDirty || millis() - pxStore->ulChangedAt < FLASH_STORE_COALESCE_MS) return;
+    vFlashStoreFlush(pxStore);
+}
+
+#endif  // FLASH_STORE_H_
@@ -0,0 +1,70 @@
+#ifndef GROUP_CONTROL_H_
+#define GROUP_CONTROL_H_
+#include <Arduino.h>
+
+// One frame on NR_MQTT_GROUP_TOPIC, shared by the whole fleet, switches every addressed device.
+// A device is addressed by its index in a bitmap or by a group ID. All multibyte fields are little endian.
+//
+// Group frame:
+//   [0]     GROUP_FRAME_COMMAND
+//   [1]     flags, GROUP_FLAG_BY_ID: addressed by group ID, otherwise by bitmap
+//   [2..3]  group ID (0..31) or the bitmap length in bytes, N
+//   [4..]   bitmap, N bytes, bit K of byte K / 8 (LSB first) is device K. No bitmap with GROUP_FLAG_BY_ID.
+//   then    channels count C, and C ops, 2 bits each, 4 per byte, channel 1 in the low bits:
+//           0 = none, 1 = ON, 2 = OFF, 3 = TOGGLE. Channels the device does not have are ignored.
+//
+// A device belongs to the groups set in NR_GROUP_MASK (bit G = group ID G) and is
+// device NR_GROUP_DEVICE_INDEX in bitmaps. Matching is one bit test either way.
+
+#ifndef NR_MQTT_GROUP
+#define NR_MQTT_GROUP false
+#endif
+#ifndef NR_MQTT_GROUP_TOPIC
+#define NR_MQTT_GROUP_TOPIC "myhome/group/set"
+#endif
+#ifndef NR_GROUP_DEVICE_INDEX
+#define NR_GROUP_DEVICE_INDEX 0
+#endif
+#ifndef NR_GROUP_MASK
+#define NR_GROUP_MASK 0UL
+#endif
+
+#define GROUP_FRAME_COMMAND     0x02
+
+#define GROUP_FLAG_BY_ID        BIT0
+
+#define GROUP_OP_NONE           0
+#define GROUP_OP_ON             1
+#define GROUP_OP_OFF            2
+#define GROUP_OP_TOGGLE         3
+
+typedef struct {
+    uint8_t uiChannels;             // ops count
+    const uint8_t * pcOps;          // points into the frame
+} group_command_t;
+
+uint8_t uiGroupOp(const group_command_t * pxCmd, uint8_t uiChannel) {
+    if (uiChannel >= pxCmd->uiChannels) return GROUP_OP_NONE;
+    return (pxCmd->pcOps[uiChannel >> 2] >> ((uiChannel & 3) << 1)) & 3;
+}
+
+// true when the frame is valid and addresses this device
+bool bGroupDecode(const uint8_t * pcFrame, size_t len, uint16_t uiDeviceIndex, uint32_t ulGroupMask, group_command_t * pxCmd) {
+    if (len < 5 || pcFrame[0] != GROUP_FRAME_COMMAND) return false;
+    uint16_t uiAddr = pcFrame[2] | (pcFrame[3] << 8);
+    size_t uiOffset = 4;
+    bool bMatch;
+    if (pcFrame[1] & GROUP_FLAG_BY_ID) {
+        bMatch = uiAddr < 32 && (ulGroupMask & (1UL << uiAddr));
+    } else {
+        if (len < uiOffset + uiAddr + 1) return false;
+        bMatch = (uiDeviceIndex >> 3) < uiAddr && (pcFrame[uiOffset + (uiDeviceIndex >> 3)] & (1 << (uiDeviceIndex & 7)));
+        uiOffset += uiAddr;
+    }
+    pxCmd->uiChannels = pcFrame[uiOffset++];
+    pxCmd->pcOps = pcFrame + uiOffset;
+    if (len < uiOffset + ((pxCmd->uiChannels + 3) >> 2)) return false;
+    return bMatch;
+}
+
+#endif  // GROUP_CONTROL_H_
@@ -0,0 +1,113 @@
+#ifndef HEATSHRINK_DECODER_H_
+#define HEATSHRINK_DECODER_H_
+#include <Arduino.h>
+
+// Streaming decoder for heatshrink (LZSS) compressed images, as written by
+//   heatshrink -e -w HS_WINDOW_BITS -l HS_LOOKAHEAD_BITS firmware.bin firmware.bin.hs
+// The bit stream is read MSB first: tag 1 + 8 bit literal, or tag 0 + (window bits) index
+// + (lookahead bits) count, a copy of count + 1 bytes from index + 1 bytes back.
+// Input may be cut anywhere, the state carries over to the next call. Memory is the
+// 2^HS_WINDOW_BITS window and nothing else. Plain C on top of Arduino.h, builds on the host
+// with a stub header, so it can be checked against the upstream heatshrink test vectors.
+
+#ifndef HS_WINDOW_BITS
+#define HS_WINDOW_BITS      10
+#endif
+#ifndef HS_LOOKAHEAD_BITS
+#define HS_LOOKAHEAD_BITS   5
+#endif
+static_assert(HS_WINDOW_BITS >= 4 && HS_WINDOW_BITS <= 15, "heatshrink window is 2^4..2^15");
+static_assert(HS_LOOKAHEAD_BITS >= 3 && HS_LOOKAHEAD_BITS < HS_WINDOW_BITS, "heatshrink lookahead is 3..window-1 bits");
+
+#define HS_WINDOW_SIZE      (1U << HS_WINDOW_BITS)
+
+typedef enum {
+    HS_STATE_TAG = 0,
+    HS_STATE_LITERAL,
+    HS_STATE_INDEX,
+    HS_STATE_COUNT
+} hs_state_t;
+
+typedef struct {
+    uint8_t pcWindow[HS_WINDOW_SIZE];
+    uint16_t uiHead;            // next write position in the window
+    uint16_t uiIndex;           // backref being read
+    uint16_t uiBits;            // bits collected for the current field
+    uint8_t uiBitCount;
+    hs_state_t xState;
+    uint32_t ulOut;             // bytes produced
+} hs_decoder_t;
+
+// Decoded bytes go here in pieces of up to HS_WINDOW_SIZE, false stops decoding
+typedef bool (*bHsSink_t)(const uint8_t * pcData, size_t len, void * pvCtx);
+
+void vHsBegin(hs_decoder_t * pxDec) {
+    memset(pxDec, 0, sizeof(hs_decoder_t));
+}
+
+// Window bytes from uiFrom up to the head go to the sink, without wrapping
+bool bHsFlush(hs_decoder_t * pxDec, uint16_t uiFrom, bHsSink_t pvSink, void * pvCtx) {
+    if (pxDec->uiHead == uiFrom) return true;
+    if (pxDec->uiHead > uiFrom) return pvSink(pxDec->pcWindow + uiFrom, pxDec->uiHead - uiFrom, pvCtx);
+    if (!pvSink(pxDec->pcWindow + uiFrom, HS_WINDOW_SIZE - uiFrom, pvCtx)) return false;
+    return pxDec->uiHead == 0 || pvSink(pxDec->pcWindow, pxDec->uiHead, pvCtx);
+}
+
+// Appends one decoded byte, hands the window to the sink whenever it wraps
+inline bool bHsPut(hs_decoder_t * pxDec, uint8_t uiByte, uint16_t * puiFrom, bHsSink_t pvSink, void * pvCtx) {
+    pxDec->pcWindow[pxDec->uiHead] = uiByte;
+    pxDec->uiHead = (pxDec->uiHead + 1) & (HS_WINDOW_SIZE - 1);
+    pxDec->ulOut++;
+    if (pxDec->uiHead != *puiFrom) return true;
+    // a full window is pending: send it before it is overwritten
+    bool bOk = pvSink(pxDec->pcWindow + *puiFrom, HS_WINDOW_SIZE - *puiFrom, pvCtx) &&
+               (*puiFrom == 0 || pvSink(pxDec->pcWindow, *puiFrom, pvCtx));
+    return bOk;
+}
+
+// Feeds the next piece of the compressed stream. false if the sink refused the output
+bool bHsFeed(hs_decoder_t * pxDec, const uint8_t * pcIn, size_t len, bHsSink_t pvSink, void * pvCtx) {
+    uint16_t uiFrom = pxDec->uiHead;
+    for (size_t i = 0; i < len; i++) {
+        uint8_t uiByte = pcIn[i];
+        for (uint8_t uiMask = 0x80; uiMask; uiMask >>= 1) {
+            uint8_t uiBit = (uiByte & uiMask) ? 1 : 0;
+            switch (pxDec->xState) {
+            case HS_STATE_TAG:
+                pxDec->xState = uiBit ? HS_STATE_LITERAL : HS_STATE_INDEX;
+                pxDec->uiBits = 0;
+                pxDec->uiBitCount = 0;
+                continue;
+            case HS_STATE_LITERAL:
+                pxDec->uiBits = (pxDec->uiBits << 1) | uiBit;
+                if (++pxDec->uiBitCount < 8) continue;
+                pxDec->xState = HS_STATE_TAG;
+                if (!bHsPut(pxDec, (uint8_t)pxDec->uiBits, &uiFrom, pvSink, pvCtx)) return false;
+                continue;
+            case HS_STATE_INDEX:
+                pxDec->uiBits = (pxDec->uiBits << 1) | uiBit;
+                if (++pxDec->uiBitCount < HS_WINDOW_BITS) continue;
+                pxDec->uiIndex = pxDec->uiBits;
+                pxDec->uiBits = 0;
+                pxDec->uiBitCount = 0;
+                pxDec->xState = HS_STATE_COUNT;
+                continue;
+            case HS_STATE_COUNT: {
+                pxDec->uiBits = (pxDec->uiBits << 1) | uiBit;
+                if (++pxDec->uiBitCount < HS_LOOKAHEAD_BITS) continue;
+                pxDec->xState = HS_STATE_TAG;
+                uint16_t uiCount = pxDec->uiBits + 1;
+                uint16_t uiOffset = pxDec->uiIndex + 1;
+                for (uint16_t n = 0; n < uiCount; n++) {
+                    uint8_t uiCopy = pxDec->pcWindow[(pxDec->uiHead - uiOffset) & (HS_WINDOW_SIZE - 1)];
+                    if (!bHsPut(pxDec, uiCopy, &uiFrom, pvSink, pvCtx)) return false;
+                }
+                continue;
+            }
+            }
+        }
+    }
+    return bHsFlush(pxDec, uiFrom, pvSink, pvCtx);
+}
+
+#endif  // HEATSHRINK_DECODER_H_
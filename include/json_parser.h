@@ -0,0 +1,173 @@
+#ifndef JSON_PARSER_H_
+#define JSON_PARSER_H_
+#include <Arduino.h>
+
+// Single pass, in-place JSON object tokenizer. Walks top level members of an object
+// and returns pointers into the payload buffer, nothing is copied and nothing is allocated.
+// String tokens are returned without the quotes and with escapes left as is,
+// nested objects/arrays are returned as one raw token.
+
+typedef enum {
+    JSON_TYPE_NONE = 0,
+    JSON_TYPE_STRING,
+    JSON_TYPE_NUMBER,
+    JSON_TYPE_BOOL,
+    JSON_TYPE_NULL,
+    JSON_TYPE_OBJECT,
+    JSON_TYPE_ARRAY
+} json_type_t;
+
+typedef struct {
+    const char * pc;
+    uint16_t uiLen;
+    json_type_t xType;
+} json_token_t;
+
+typedef struct {
+    const char * pcCur;
+    const char * pcEnd;
+    bool bError;
+    bool bMember;       // a member was read, the next one must follow a ','
+} json_cursor_t;
+
+void vJsonSkipSpaces(json_cursor_t * pxCur) {
+    while (pxCur->pcCur < pxCur->pcEnd) {
+        char c = *pxCur->pcCur;
+        if (c != ' ' && c != '\t' && c != '\r' && c != '\n') break;
+        pxCur->pcCur++;
+    }
+}
+
+bool bJsonFail(json_cursor_t * pxCur) {
+    pxCur->bError = true;
+    pxCur->pcCur = pxCur->pcEnd;
+    return false;
+}
+
+// Cursor must point to the opening quote
+bool bJsonReadString(json_cursor_t * pxCur, json_token_t * pxTok) {
+    const char * pc = ++pxCur->pcCur;
+    while (pxCur->pcCur < pxCur->pcEnd) {
+        char c = *pxCur->pcCur;
+        if (c == '\\') {
+            pxCur->pcCur += 2;
+            continue;
+        }
+        if (c == '"') {
+            pxTok->pc = pc;
+            pxTok->uiLen = pxCur->pcCur - pc;
+            pxTok->xType = JSON_TYPE_STRING;
+            pxCur->pcCur++;
+            return true;
+        }
+        pxCur->pcCur++;
+    }
+    return bJsonFail(pxCur);
+}
+
+// Skips nested object/array as a whole, cursor must point to the opening bracket
+bool bJsonReadNested(json_cursor_t * pxCur, json_token_t * pxTok) {
+    const char * pc = pxCur->pcCur;
+    uint8_t uiDepth = 0;
+    bool bInString = false;
+    while (pxCur->pcCur < pxCur->pcEnd) {
+        char c = *pxCur->pcCur++;
+        if (bInString) {
+            if (c == '\\') pxCur->pcCur++;
+            else if (c == '"') bInString = false;
+            continue;
+        }
+        if (c == '"') bInString = true;
+        else if (c == '{' || c == '[') uiDepth++;
+        else if (c == '}' || c == ']') {
+            if (--uiDepth == 0) {
+                pxTok->pc = pc;
+                pxTok->uiLen = pxCur->pcCur - pc;
+                pxTok->xType = (*pc == '{') ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY;
+                return true;
+            }
+        }
+    }
+    return bJsonFail(pxCur);
+}
+
+bool bJsonReadValue(json_cursor_t * pxCur, json_token_t * pxTok) {
+    vJsonSkipSpaces(pxCur);
+    if (pxCur->pcCur >= pxCur->pcEnd) return bJsonFail(pxCur);
+    char c = *pxCur->pcCur;
+    if (c == '"') return bJsonReadString(pxCur, pxTok);
+    if (c == '{' || c == '[') return bJsonReadNested(pxCur, pxTok);
+
+    // number or literal: read up to the next delimiter
+    const char * pc = pxCur->pcCur;
+    while (pxCur->pcCur < pxCur->pcEnd) {
+        c = *pxCur->pcCur;
+        if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\r' || c == '\n') break;
+        pxCur->pcCur++;
+    }
+    pxTok->pc = pc;
+    pxTok->uiLen = pxCur->pcCur - pc;
+    if (pxTok->uiLen == 0) return bJsonFail(pxCur);
+    if (*pc == 't' || *pc == 'f') pxTok->xType = JSON_TYPE_BOOL;
+    else if (*pc == 'n') pxTok->xType = JSON_TYPE_NULL;
+    else if (*pc == '-' || (*pc >= '0' && *pc <= '9')) pxTok->xType = JSON_TYPE_NUMBER;
+    else return bJsonFail(pxCur);
+    return true;
+}
+
+// Starts iterating the object in pc[0..len). Returns false if it is not an object.
+bool bJsonBegin(json_cursor_t * pxCur, const char * pc, size_t len) {
+    pxCur->pcCur = pc;
+    pxCur->pcEnd = pc + len;
+    pxCur->bError = false;
+    pxCur->bMember = false;
+    vJsonSkipSpaces(pxCur);
+    if (pxCur->pcCur >= pxCur->pcEnd || *pxCur->pcCur != '{') return bJsonFail(pxCur);
+    pxCur->pcCur++;
+    return true;
+}
+
+// Reads the next "key": value pair. Returns false at the end of the object or on a syntax error,
+// check pxCur->bError to tell them apart.
+bool bJsonNextMember(json_cursor_t * pxCur, json_token_t * pxKey, json_token_t * pxValue) {
+    vJsonSkipSpaces(pxCur);
+    if (pxCur->pcCur >= pxCur->pcEnd) return bJsonFail(pxCur);
+    if (*pxCur->pcCur == '}') {
+        pxCur->pcCur = pxCur->pcEnd;
+        return false;
+    }
+    if (pxCur->bMember) {
+        if (*pxCur->pcCur != ',') return bJsonFail(pxCur);
+        pxCur->pcCur++;
+        vJsonSkipSpaces(pxCur);
+        if (pxCur->pcCur >= pxCur->pcEnd) return bJsonFail(pxCur);
+    }
+    if (*pxCur->pcCur != '"' || !bJsonReadString(pxCur, pxKey)) return bJsonFail(pxCur);
+    vJsonSkipSpaces(pxCur);
+    if (pxCur->pcCur >= pxCur->pcEnd || *pxCur->pcCur != ':') return bJsonFail(pxCur);
+    pxCur->pcCur++;
+    pxCur->bMember = true;
+    return bJsonReadValue(pxCur, pxValue);
+}
+
+bool bJsonTokenEq(const json_token_t * pxTok, const char * pcStr) {
+    size_t len = strlen(pcStr);
+    return (pxTok->uiLen == len) && (memcmp(pxTok->pc, pcStr, len) == 0);
+}
+
+// Number token of plain digits up to ulMax. No sign, fraction or exponent, nothing is clamped.
+bool bJsonTokenToUInt(const json_token_t * pxTok, uint32_t ulMax, uint32_t * pulValue) {
+    if (pxTok->xType != JSON_TYPE_NUMBER || pxTok->uiLen == 0) return false;
+    uint32_t ulValue = 0;
+    for (uint16_t i = 0; i < pxTok->uiLen; i++) {
+        char c = pxTok->pc[i];
+        if (c < '0' || c > '9') return false;
+        uint32_t ulDigit = c - '0';
+        if (ulDigit > ulMax || ulValue > (ulMax - ulDigit) / 10) return false;
+        ulValue = ulValue * 10 + ulDigit;
+    }
+    *pulValue = ulValue;
+    return true;
+}
+
+#endif  // JSON_PARSER_H_
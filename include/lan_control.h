@@ -0,0 +1,154 @@
+#ifndef LAN_CONTROL_H_
+#define LAN_CONTROL_H_
+#include <Arduino.h>
+#include <WiFiUdp.h>
+#include <bearssl/bearssl_hmac.h>
+#include <binary_protocol.h>
+
+// Direct LAN control over UDP port NR_LAN_UDP_PORT, no broker involved, works while it is down.
+// Datagrams wrap the binary frames of binary_protocol.h. Multibyte fields are little endian.
+//   [0]       LAN_FRAME_COMMAND, LAN_FRAME_QUERY or LAN_FRAME_STATE (device reply)
+//   [1..4]    boot ID of the device, random at every boot. Commands must carry the current one,
+//             a query may send anything and learns it from the reply.
+//   [5..8]    counter, chosen by the controller. A reply echoes the request's counter.
+//   [9..]     command: a BIN_FRAME_COMMAND frame; query: nothing; reply: a BIN_FRAME_STATE frame
+//   last 16   HMAC-SHA256 of everything before it with NR_LAN_KEY, truncated
+// Replay protection: the boot ID pins a datagram to one boot, and inside a boot a counter is
+// accepted once, if it is above the highest one seen or among the LAN_REPLAY_WINDOW below it.
+// Controllers sharing the key should therefore count from a common clock, e.g. milliseconds.
+
+#ifndef NR_LAN_CONTROL
+#define NR_LAN_CONTROL false
+#endif
+#ifndef NR_LAN_UDP_PORT
+#define NR_LAN_UDP_PORT 4210
+#endif
+#ifndef NR_LAN_KEY
+#define NR_LAN_KEY ""
+#endif
+
+#define LAN_FRAME_COMMAND   0x11
+#define LAN_FRAME_QUERY     0x12
+#define LAN_FRAME_STATE     0x91
+
+#define LAN_HEADER_LEN      9
+#define LAN_MAC_LEN         16
+#define LAN_REPLAY_WINDOW   32
+#define LAN_FRAME_MAX       (LAN_HEADER_LEN + BIN_STATE_LEN + LAN_MAC_LEN)
+#define LAN_POLL_MAX        4           // datagrams per loop() pass
+
+typedef struct {
+    uint8_t uiType;
+    uint32_t ulCounter;
+    bin_command_t xCommand;     // LAN_FRAME_COMMAND only
+    IPAddress xPeer;
+    uint16_t uiPeerPort;
+} lan_request_t;
+
+typedef struct {
+    uint32_t ulBootId;
+    uint32_t ulCounterMax;
+    uint32_t ulSeen;            // bit N: ulCounterMax - N was accepted
+    bool bAny;
+    uint32_t ulAccepted;
+    uint32_t ulRejected;        // bad MAC, boot ID, replay or format
+} lan_control_t;
+
+uint32_t ulLanGet32(const uint8_t * pc) {
+    return pc[0] | (pc[1] << 8) | ((uint32_t)pc[2] << 16) | ((uint32_t)pc[3] << 24);
+}
+
+void vLanPut32(uint8_t * pc, uint32_t ulValue) {
+    vBinPut16(pc, ulValue & 0xFFFF);
+    vBinPut16(pc + 2, ulValue >> 16);
+}
+
+// Marks the counter as used, false if it was used already or fell out of the window
+bool bLanReplayCheck(lan_control_t * pxLan, uint32_t ulCounter) {
+    if (!pxLan->bAny || (int32_t)(ulCounter - pxLan->ulCounterMax) > 0) {
+        uint32_t ulShift = pxLan->bAny ? ulCounter - pxLan->ulCounterMax : LAN_REPLAY_WINDOW;
+        pxLan->ulSeen = (ulShift >= LAN_REPLAY_WINDOW) ? 1 : (pxLan->ulSeen << ulShift) | 1;
+        pxLan->ulCounterMax = ulCounter;
+        pxLan->bAny = true;
+        return true;
+    }
+    uint32_t ulAge = pxLan->ulCounterMax - ulCounter;
+    if (ulAge >= LAN_REPLAY_WINDOW || (pxLan->ulSeen & (1UL << ulAge))) return false;
+    pxLan->ulSeen |= 1UL << ulAge;
+    return true;
+}
+
+#if NR_LAN_CONTROL
+
+static_assert(sizeof(NR_LAN_KEY) - 1 >= 16, "NR_LAN_KEY must be set, 16 characters or more");
+
+lan_control_t xLanControl;
+WiFiUDP xLanUdp;
+br_hmac_key_context xLanKey;
+
+void vLanMac(const uint8_t * pcData, size_t len, uint8_t * pcMac) {
+    br_hmac_context xCtx;
+    br_hmac_init(&xCtx, &xLanKey, LAN_MAC_LEN);
+    br_hmac_update(&xCtx, pcData, len);
+    br_hmac_out(&xCtx, pcMac);
+}
+
+bool bLanMacOk(const uint8_t * pcData, size_t len) {
+    uint8_t pcMac[LAN_MAC_LEN];
+    vLanMac(pcData, len, pcMac);
+    uint8_t uiDiff = 0;
+    for (uint8_t i = 0; i < LAN_MAC_LEN; i++) uiDiff |= pcMac[i] ^ pcData[len + i];     // constant time
+    return uiDiff == 0;
+}
+
+void vLanBegin() {
+    br_hmac_key_init(&xLanKey, &br_sha256_vtable, NR_LAN_KEY, sizeof(NR_LAN_KEY) - 1);
+    xLanControl.ulBootId = ESP.random();
+    xLanUdp.begin(NR_LAN_UDP_PORT);
+}
+
+// Next authentic, fresh request, false when there is none. Everything else is dropped and counted.
+bool bLanPoll(lan_request_t * pxReq) {
+    uint8_t pcFrame[LAN_HEADER_LEN + BIN_COMMAND_LEN + LAN_MAC_LEN];
+    for (uint8_t n = 0; n < LAN_POLL_MAX; n++) {
+        int iSize = xLanUdp.parsePacket();
+        if (iSize <= 0) return false;
+        size_t len = xLanUdp.read(pcFrame, sizeof(pcFrame));
+        xLanUdp.flush();
+        size_t uiBody = (pcFrame[0] == LAN_FRAME_COMMAND) ? BIN_COMMAND_LEN : 0;
+        bool bOk = (size_t)iSize == len && len == LAN_HEADER_LEN + uiBody + LAN_MAC_LEN &&
+                   (pcFrame[0] == LAN_FRAME_COMMAND || pcFrame[0] == LAN_FRAME_QUERY) &&
+                   bLanMacOk(pcFrame, len - LAN_MAC_LEN);
+        if (bOk && pcFrame[0] == LAN_FRAME_COMMAND) {
+            bOk = ulLanGet32(pcFrame + 1) == xLanControl.ulBootId && bBinDecodeCommand(pcFrame + LAN_HEADER_LEN, uiBody, &pxReq->xCommand);
+        }
+        if (bOk) bOk = bLanReplayCheck(&xLanControl, ulLanGet32(pcFrame + 5));     // only after the MAC
+        if (!bOk) {
+            xLanControl.ulRejected++;
+            continue;
+        }
+        pxReq->uiType = pcFrame[0];
+        pxReq->ulCounter = ulLanGet32(pcFrame + 5);
+        pxReq->xPeer = xLanUdp.remoteIP();
+        pxReq->uiPeerPort = xLanUdp.remotePort();
+        xLanControl.ulAccepted++;
+        return true;
+    }
+    return false;
+}
+
+void vLanReply(const lan_request_t * pxReq, const bin_state_t * pxState) {
+    uint8_t pcFrame[LAN_FRAME_MAX];
+    pcFrame[0] = LAN_FRAME_STATE;
+    vLanPut32(pcFrame + 1, xLanControl.ulBootId);
+    vLanPut32(pcFrame + 5, pxReq->ulCounter);
+    size_t len = LAN_HEADER_LEN + uiBinEncodeState(pcFrame + LAN_HEADER_LEN, pxState);
+    vLanMac(pcFrame, len, pcFrame + len);
+    xLanUdp.beginPacket(pxReq->xPeer, pxReq->uiPeerPort);
+    xLanUdp.write(pcFrame, len + LAN_MAC_LEN);
+    xLanUdp.endPacket();
+}
+
+#endif  // NR_LAN_CONTROL
+
+#endif  // LAN_CONTROL_H_
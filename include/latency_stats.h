@@ -0,0 +1,103 @@
+#ifndef LATENCY_STATS_H_
+#define LATENCY_STATS_H_
+#include <Arduino.h>
+
+// Field latency telemetry, returned by the "LATENCY" command, one report per histogram:
+//  - broker_rtt_ms: a QoS0 probe on NR_MQTT_RTT_TOPIC, published and received back by this device,
+//    every RTT_PROBE_INTERVAL_MS. A slow AP or an overloaded broker shows here first;
+//  - cmd_actuate_us: command parsed -> relays switched;
+//  - puback_ms: state report published -> PUBACK.
+// Each one keeps count/min/avg/max and a log2 histogram: bucket N counts samples of 2^N..2^(N+1)-1,
+// the last one everything longer. Counters run from boot, the backend takes the differences.
+// Compiled out when NR_LATENCY_STATS is false.
+
+#ifndef NR_LATENCY_STATS
+#define NR_LATENCY_STATS true
+#endif
+#ifndef NR_MQTT_RTT_TOPIC
+#define NR_MQTT_RTT_TOPIC NR_MQTT_REPORT_TOPIC "/rtt"
+#endif
+#ifndef RTT_PROBE_INTERVAL_MS
+#define RTT_PROBE_INTERVAL_MS   30000
+#endif
+#ifndef RTT_PROBE_TIMEOUT_MS
+#define RTT_PROBE_TIMEOUT_MS    10000   // a later echo is counted as lost
+#endif
+
+#define LAT_BUCKETS     16
+
+typedef enum {
+    LAT_BROKER_RTT = 0,
+    LAT_CMD_ACTUATE,
+    LAT_PUBACK,
+    LAT_HISTS_COUNT
+} lat_hist_id_t;
+
+const char * const pcLatHistNames[LAT_HISTS_COUNT] = {
+    "broker_rtt_ms", "cmd_actuate_us", "puback_ms"
+};
+
+typedef struct {
+    uint32_t ulCount;
+    uint32_t ulMin;
+    uint32_t ulMax;
+    uint64_t ullSum;
+    uint32_t ulHist[LAT_BUCKETS];
+} lat_hist_t;
+
+typedef struct {
+    uint32_t ulSentAt;
+    bool bPending;      // waiting for the echo
+    uint32_t ulSent;
+    uint32_t ulLost;
+} rtt_probe_t;
+
+#if NR_LATENCY_STATS
+
+lat_hist_t xLatHists[LAT_HISTS_COUNT];
+rtt_probe_t xRttProbe;
+
+void vLatAdd(lat_hist_id_t xId, uint32_t ulValue) {
+    lat_hist_t * pxHist = &xLatHists[xId];
+    if (pxHist->ulCount == 0 || ulValue < pxHist->ulMin) pxHist->ulMin = ulValue;
+    if (ulValue > pxHist->ulMax) pxHist->ulMax = ulValue;
+    pxHist->ullSum += ulValue;
+    pxHist->ulCount++;
+    uint8_t uiBucket = 0;
+    while (ulValue > 1 && uiBucket < LAT_BUCKETS - 1) {
+        ulValue >>= 1;
+        uiBucket++;
+    }
+    pxHist->ulHist[uiBucket]++;
+}
+
+// Payload of the next probe, its send time in decimal
+size_t uiRttProbeStart(rtt_probe_t * pxProbe, char * pcPayload, size_t uiSize, uint32_t ulNow) {
+    if (pxProbe->bPending && ulNow - pxProbe->ulSentAt >= RTT_PROBE_TIMEOUT_MS) pxProbe->ulLost++;
+    pxProbe->ulSentAt = ulNow;
+    pxProbe->bPending = true;
+    pxProbe->ulSent++;
+    return snprintf(pcPayload, uiSize, "%u", ulNow);
+}
+
+// Echo came back. Anything but the probe in flight (a duplicate, a late one) is ignored.
+bool bRttProbeEcho(rtt_probe_t * pxProbe, const char * pcPayload, uint32_t ulNow, uint32_t * pulRttMs) {
+    if (!pxProbe->bPending || strtoul(pcPayload, NULL, 10) != pxProbe->ulSentAt) return false;
+    pxProbe->bPending = false;
+    *pulRttMs = ulNow - pxProbe->ulSentAt;
+    if (*pulRttMs >= RTT_PROBE_TIMEOUT_MS) {
+        pxProbe->ulLost++;
+        return false;
+    }
+    return true;
+}
+
+#define LATENCY_SAMPLE(id, value)   vLatAdd(id, value)
+
+#else
+
+#define LATENCY_SAMPLE(id, value)
+
+#endif  // NR_LATENCY_STATS
+
+#endif  // LATENCY_STATS_H_
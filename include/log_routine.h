@@ -0,0 +1,230 @@
+#ifndef LOG_ROUTINE_H_
+#define LOG_ROUTINE_H_
+#include <Arduino.h>
+#include <type_traits>
+#include <spsc_queue.h>
+
+// Deferred serial log. LOG_ERROR/LOG_WARN/LOG_INFO/LOG_DEBUG(fmt, ...) keep the format string in flash
+// and only push a binary record to a lock-free ring: the format pointer, a timestamp and the raw
+// arguments, strings copied into the record. vLogHandler() formats them from loop() and writes no more
+// than the UART takes without blocking. Levels above NR_LOG_LEVEL are not compiled in at all.
+// A full ring drops the new record and counts it, the count goes out once the ring is drained.
+//
+// Formats: integer conversions (32 bit, "ll" for 64), %c, %s and * width/precision. No floats.
+// All strings of one record share LOG_STR_LEN bytes, longer ones are cut.
+
+#define LOG_LEVEL_NONE      0
+#define LOG_LEVEL_ERROR     1
+#define LOG_LEVEL_WARN      2
+#define LOG_LEVEL_INFO      3
+#define LOG_LEVEL_DEBUG     4
+
+#ifndef NR_LOG_LEVEL
+#define NR_LOG_LEVEL    LOG_LEVEL_INFO
+#endif
+#ifndef LOG_RING_SIZE
+#define LOG_RING_SIZE   32      // power of two
+#endif
+#define LOG_MAX_ARGS    8       // 32 bit words
+#define LOG_STR_LEN     32
+#define LOG_LINE_LEN    160
+
+typedef struct {
+    PGM_P pcFmt;
+    uint32_t ulMs;
+    uint8_t uiLevel;
+    uint8_t uiArgc;
+    uint8_t uiStrLen;
+    uint32_t ulArgs[LOG_MAX_ARGS];
+    char pcStr[LOG_STR_LEN];
+} log_record_t;
+
+spsc_queue_t<log_record_t, LOG_RING_SIZE> xLogRing;
+
+const char pcLogLevelChars[] = "-EWID";
+
+void vLogPutWord(log_record_t * pxRec, uint32_t ulWord) {
+    if (pxRec->uiArgc < LOG_MAX_ARGS) pxRec->ulArgs[pxRec->uiArgc++] = ulWord;
+}
+
+// Copies the string into the record, the argument is its offset there
+void vLogPut(log_record_t * pxRec, const char * pc) {
+    if (pc == NULL) pc = "(null)";
+    uint8_t uiOffset = min((uint8_t)pxRec->uiStrLen, (uint8_t)(LOG_STR_LEN - 1));    // full: the last NUL, ""
+    size_t uiLen = strnlen(pc, LOG_STR_LEN - 1 - uiOffset);
+    memcpy(pxRec->pcStr + uiOffset, pc, uiLen);
+    pxRec->pcStr[uiOffset + uiLen] = '\0';
+    pxRec->uiStrLen = uiOffset + uiLen + 1;
+    vLogPutWord(pxRec, uiOffset);
+}
+
+void vLogPut(log_record_t * pxRec, char * pc) {
+    vLogPut(pxRec, (const char *)pc);
+}
+
+template <typename T>
+void vLogPut(log_record_t * pxRec, T xValue) {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "integers and strings only");
+    uint64_t ullValue = (uint64_t)xValue;
+    vLogPutWord(pxRec, (uint32_t)ullValue);
+    if (sizeof(T) > 4) vLogPutWord(pxRec, (uint32_t)(ullValue >> 32));
+}
+
+void vLogPutAll(log_record_t * pxRec) {}
+
+template <typename T, typename... R>
+void vLogPutAll(log_record_t * pxRec, T xFirst, R... xRest) {
+    vLogPut(pxRec, xFirst);
+    vLogPutAll(pxRec, xRest...);
+}
+
+template <typename... A>
+void vLogPush(uint8_t uiLevel, PGM_P pcFmt, A... xArgs) {
+    log_record_t xRec;
+    xRec.pcFmt = pcFmt;
+    xRec.ulMs = millis();
+    xRec.uiLevel = uiLevel;
+    xRec.uiArgc = 0;
+    xRec.uiStrLen = 0;
+    vLogPutAll(&xRec, xArgs...);
+    bQueuePush(&xLogRing, &xRec);
+}
+
+#define LOG_PUSH(level, fmt, ...)   vLogPush(level, PSTR(fmt), ##__VA_ARGS__)
+
+#if NR_LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(fmt, ...)     LOG_PUSH(LOG_LEVEL_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_ERROR(fmt, ...)     do {} while (0)
+#endif
+#if NR_LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(fmt, ...)      LOG_PUSH(LOG_LEVEL_WARN, fmt, ##__VA_ARGS__)
+#else
+#define LOG_WARN(fmt, ...)      do {} while (0)
+#endif
+#if NR_LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(fmt, ...)      LOG_PUSH(LOG_LEVEL_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOG_INFO(fmt, ...)      do {} while (0)
+#endif
+#if NR_LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(fmt, ...)     LOG_PUSH(LOG_LEVEL_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_DEBUG(fmt, ...)     do {} while (0)
+#endif
+
+// Formats one record the way snprintf would have done at the call, "<ms> <level> " first
+size_t uiLogFormat(const log_record_t * pxRec, char * pcLine, size_t uiSize) {
+    char pcFmt[LOG_LINE_LEN];
+    strncpy_P(pcFmt, pxRec->pcFmt, sizeof(pcFmt) - 1);
+    pcFmt[sizeof(pcFmt) - 1] = '\0';
+    uint8_t uiArg = 0;
+    auto ulNextArg = [&]() -> uint32_t { return uiArg < pxRec->uiArgc ? pxRec->ulArgs[uiArg++] : 0; };
+    size_t uiLen = snprintf(pcLine, uiSize, "%u %c ", (unsigned)pxRec->ulMs, pcLogLevelChars[pxRec->uiLevel]);
+    const char * pc = pcFmt;
+    while (*pc && uiLen < uiSize - 1) {
+        if (*pc != '%') {
+            pcLine[uiLen++] = *pc++;
+            continue;
+        }
+        if (pc[1] == '%') {
+            pcLine[uiLen++] = '%';
+            pc += 2;
+            continue;
+        }
+        // %[flags][width][.precision][length]type, * resolved in place, length dropped but "ll"
+        char pcSpec[24];
+        uint8_t uiSpec = 0;
+        bool bWide = false;
+        pcSpec[uiSpec++] = *pc++;
+        while (*pc && strchr("-+ #0123456789.*hlzjt", *pc) && uiSpec < sizeof(pcSpec) - 14) {
+            if (*pc == '*') {
+                uiSpec += snprintf(pcSpec + uiSpec, sizeof(pcSpec) - uiSpec, "%d", (int)ulNextArg());
+            } else if (*pc == 'j' || (*pc == 'l' && pc[1] == 'l')) {
+                bWide = true;
+            } else if (!strchr("hlzt", *pc)) {
+                pcSpec[uiSpec++] = *pc;
+            }
+            pc++;
+        }
+        if (!*pc) break;
+        char cType = *pc++;
+        if (bWide) {
+            pcSpec[uiSpec++] = 'l';
+            pcSpec[uiSpec++] = 'l';
+        }
+        pcSpec[uiSpec++] = cType;
+        pcSpec[uiSpec] = '\0';
+        char * pcOut = pcLine + uiLen;
+        size_t uiRoom = uiSize - uiLen;
+        int iLen = 0;
+        switch (cType) {
+        case 'd':
+        case 'i':
+            if (bWide) {
+                uint64_t ullValue = ulNextArg();
+                ullValue |= (uint64_t)ulNextArg() << 32;
+                iLen = snprintf(pcOut, uiRoom, pcSpec, (long long)ullValue);
+            } else {
+                iLen = snprintf(pcOut, uiRoom, pcSpec, (int)ulNextArg());
+            }
+            break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+            if (bWide) {
+                uint64_t ullValue = ulNextArg();
+                ullValue |= (uint64_t)ulNextArg() << 32;
+                iLen = snprintf(pcOut, uiRoom, pcSpec, (unsigned long long)ullValue);
+            } else {
+                iLen = snprintf(pcOut, uiRoom, pcSpec, (unsigned)ulNextArg());
+            }
+            break;
+        case 'c':
+            iLen = snprintf(pcOut, uiRoom, pcSpec, (int)ulNextArg());
+            break;
+        case 's':
+            iLen = snprintf(pcOut, uiRoom, pcSpec, pxRec->pcStr + min(ulNextArg(), (uint32_t)(LOG_STR_LEN - 1)));
+            break;
+        default:
+            iLen = snprintf(pcOut, uiRoom, "%s", pcSpec);
+            break;
+        }
+        if (iLen > 0) uiLen = min(uiLen + iLen, uiSize - 1);
+    }
+    pcLine[uiLen] = '\0';
+    return uiLen;
+}
+
+char pcLogLine[LOG_LINE_LEN + 1];
+size_t uiLogLineLen = 0;
+size_t uiLogLineSent = 0;
+uint32_t ulLogDroppedShown = 0;
+
+// Called from loop(). Writes what the UART takes without blocking, formats the next record
+// once the current line is out.
+void vLogHandler() {
+    while (true) {
+        if (uiLogLineSent == uiLogLineLen) {
+            log_record_t xRec;
+            if (bQueuePop(&xLogRing, &xRec)) {
+                uiLogLineLen = uiLogFormat(&xRec, pcLogLine, sizeof(pcLogLine) - 1);
+                pcLogLine[uiLogLineLen++] = '\n';
+            } else if (xLogRing.ulDropped != ulLogDroppedShown) {
+                uiLogLineLen = snprintf(pcLogLine, sizeof(pcLogLine), "[ log ] %u records dropped\n", (unsigned)(xLogRing.ulDropped - ulLogDroppedShown));
+                ulLogDroppedShown = xLogRing.ulDropped;
+            } else {
+                return;
+            }
+            uiLogLineSent = 0;
+        }
+        size_t uiRoom = Serial.availableForWrite();
+        if (uiRoom == 0) return;
+        size_t uiChunk = min(uiRoom, uiLogLineLen - uiLogLineSent);
+        Serial.write((const uint8_t *)pcLogLine + uiLogLineSent, uiChunk);
+        uiLogLineSent += uiChunk;
+    }
+}
+
+#endif  // LOG_ROUTINE_H_
@@ -0,0 +1,63 @@
+#ifndef MQTT_REASSEMBLY_H_
+#define MQTT_REASSEMBLY_H_
+#include <Arduino.h>
+
+// AsyncMqttClient hands a payload larger than one TCP segment over in chunks (index, total).
+// Chunks of one message come in order and are never mixed with another message,
+// so one preallocated buffer is enough. It is keyed by the route (topic) of the first chunk,
+// a chunk that does not continue the message in progress aborts it.
+// Messages longer than MQTT_MESSAGE_MAX_LEN are refused on their first chunk, the rest is skipped.
+// The complete message is NUL terminated in our buffer, the library's one is never written.
+
+#ifndef MQTT_MESSAGE_MAX_LEN
+#define MQTT_MESSAGE_MAX_LEN    1024
+#endif
+
+typedef struct {
+    char pcBuf[MQTT_MESSAGE_MAX_LEN + 1];
+    const void * pvKey;         // route of the message in progress, NULL = idle
+    size_t uiTotal;
+    size_t uiReceived;
+    bool bSkipping;             // refused, waiting for its last chunk
+    uint32_t ulChunked;         // complete messages that came in more than one chunk
+    uint32_t ulOversized;
+    uint32_t ulAborted;
+} mqtt_reassembly_t;
+
+// true when pcBuf holds the complete message, uiTotal bytes long
+bool bReasmFeed(mqtt_reassembly_t * pxAsm, const void * pvKey, const char * pcChunk, size_t len, size_t index, size_t total) {
+    if (index == 0) {
+        if (pxAsm->pvKey || pxAsm->bSkipping) pxAsm->ulAborted++;
+        pxAsm->pvKey = NULL;
+        pxAsm->bSkipping = false;
+        if (total > MQTT_MESSAGE_MAX_LEN) {
+            pxAsm->ulOversized++;
+            pxAsm->bSkipping = (len < total);
+            return false;
+        }
+        pxAsm->pvKey = pvKey;
+        pxAsm->uiTotal = total;
+        pxAsm->uiReceived = 0;
+    } else if (pxAsm->bSkipping) {
+        if (index + len >= total) pxAsm->bSkipping = false;
+        return false;
+    } else if (pxAsm->pvKey != pvKey || index != pxAsm->uiReceived || total != pxAsm->uiTotal) {
+        if (pxAsm->pvKey) pxAsm->ulAborted++;
+        pxAsm->pvKey = NULL;
+        return false;
+    }
+    if (len > pxAsm->uiTotal - pxAsm->uiReceived) {     // should never happen, do not overrun
+        pxAsm->ulAborted++;
+        pxAsm->pvKey = NULL;
+        return false;
+    }
+    memcpy(pxAsm->pcBuf + pxAsm->uiReceived, pcChunk, len);
+    pxAsm->uiReceived += len;
+    if (pxAsm->uiReceived < pxAsm->uiTotal) return false;
+    if (index > 0) pxAsm->ulChunked++;
+    pxAsm->pcBuf[pxAsm->uiTotal] = '\0';
+    pxAsm->pvKey = NULL;
+    return true;
+}
+
+#endif  // MQTT_REASSEMBLY_H_
@@ -1,15 +1,38 @@
 #ifndef NET_ROUTINE_H_
 #define NET_ROUTINE_H_
 #include <ESP8266WiFi.h>
-#include <Ticker.h>
 #include <AsyncMqttClient.h>
 #include <ArduinoOTA.h>
+#include <bench_routine.h>
+#include <log_routine.h>
+#include <mqtt_reassembly.h>
+#include <net_session.h>
+#include <profiler.h>
+#include <timer_wheel.h>
+#include <topic_router.h>
+
+// Persistent session: the client connects with cleanSession=false, so the broker keeps the
+// subscriptions and the QoS1 commands sent meanwhile over a short drop. When it reports the
+// session present, nothing is resubscribed, except on the first connect after boot (the routes
+// may have changed with the firmware). The will marks NR_MQTT_AVAIL_TOPIC "offline", the connect
+// "online", both retained; the sketch keeps a retained state topic per channel up to date.
+#ifndef NR_MQTT_PERSISTENT
+#define NR_MQTT_PERSISTENT false
+#endif
+#ifndef NR_MQTT_CLIENT_ID
+#define NR_MQTT_CLIENT_ID ""                // "": the library's "esp8266-<chip id>", stable as well
+#endif
+#ifndef NR_MQTT_AVAIL_TOPIC
+#define NR_MQTT_AVAIL_TOPIC NR_MQTT_REPORT_TOPIC "/status"
+#endif
 
 const char * deviceId = NR_DEVICE_ID;
 const char * mqttReportTopic = NR_MQTT_REPORT_TOPIC;
 const char * mqttSetTopic = NR_MQTT_SET_TOPIC;
-const char * mqttPingTopic = NR_MQTT_PING_TOPIC;
 const char * deviceAlias = NR_DEVICE_ALIAS;
+#if NR_MQTT_BINARY
+const char * mqttBinReportTopic = NR_MQTT_BIN_REPORT_TOPIC;
+#endif
 
 const char * ssid = NR_SSID;
 const char * password = NR_PASSWORD;
@@ -19,9 +42,12 @@ const char * mqttPassword = NR_MQTT_PASSWORD;
 const char * mqttServer = NR_MQTT_SERVER_URL;
 const uint16_t mqttPort = NR_MQTT_SERVER_PORT;
 
-typedef void (*vMessageCB_t)(char* topic, char* payload, size_t len);
-vMessageCB_t pvMessageCB = NULL;
-vMessageCB_t pvPingCB = NULL;
+// Every route is subscribed on connect, see topic_router.h
+topic_router_t xTopicRouter;
+mqtt_reassembly_t xMqttReasm;
+
+typedef void (*vPublishAckCB_t)(uint16_t uiPacketId);
+vPublishAckCB_t pvPublishAckCB = NULL;
 
 
 typedef enum {
@@ -35,27 +61,84 @@ typedef void (*vNetEventCB_t)(net_event_code_t xEventCode);
 vNetEventCB_t pvNetEventCB = NULL;
 
 AsyncMqttClient mqttClient;
-Ticker mqttReconnectTimer;
+wheel_timer_t mqttReconnectTimer;
 
 WiFiEventHandler wifiConnectHandler;
 WiFiEventHandler wifiDisconnectHandler;
-Ticker wifiReconnectTimer;
+wheel_timer_t wifiReconnectTimer;
+
+net_session_t xNetSession;          // bSessionBegin() is called from setup() before netSetup()
+bool bWifiFastPath = false;         // fast attempt in progress, not proven by an MQTT connect yet
+uint8_t uiWifiAttempts = 0;
+uint8_t uiMqttAttempts = 0;
+uint32_t ulBootMqttMs = 0;          // power-on to the first MQTT connect
+bool bMqttSessionPresent = false;   // the broker kept our session over the last reconnect
 
 void connectToWifi();
 void connectToMqtt();
 void setupOTAServer();
 
+void wifiFastTimeoutCB(uint32_t ulArg);
+
 void connectToWifi() {
-  Serial.printf("[ connectToWifi ] Connecting to Wi-Fi %s (%s) ...\n", ssid, password);
+  if (xNetSession.uiFlags & SESSION_WIFI) {
+    LOG_INFO("[ connectToWifi ] Fast connect to Wi-Fi %s, channel %i ...", ssid, xNetSession.uiChannel);
+    WiFi.config(IPAddress(xNetSession.ulIp), IPAddress(xNetSession.ulGateway), IPAddress(xNetSession.ulMask), IPAddress(xNetSession.ulDns));
+    WiFi.begin(ssid, password, xNetSession.uiChannel, xNetSession.pcBssid);
+    bWifiFastPath = true;
+    vTimerArm(&xTimerWheel, &wifiReconnectTimer, NET_FAST_CONNECT_TIMEOUT_MS, wifiFastTimeoutCB);
+    return;
+  }
+  LOG_INFO("[ connectToWifi ] Connecting to Wi-Fi %s ...", ssid);
+  WiFi.config(IPAddress(0u), IPAddress(0u), IPAddress(0u));   // DHCP
   WiFi.begin(ssid, password);
+  bWifiFastPath = false;
+}
+
+void wifiReconnectCB(uint32_t ulArg) {
+  connectToWifi();
+}
+
+// Cached AP or lease did not work out, forget them and scan
+void wifiFastFailed() {
+  LOG_WARN("[ wifiFastFailed ] Fast connect failed, falling back to a full scan");
+  vSessionForgetWifi(&xNetSession);
+  bWifiFastPath = false;
+  vTimerArm(&xTimerWheel, &wifiReconnectTimer, 0, wifiReconnectCB);
+}
+
+// Backstop in case the SDK reports no disconnect for an attempt it had not got far with
+void wifiFastGuardCB(uint32_t ulArg) {
+  if (bWifiFastPath && !WiFi.isConnected()) wifiFastFailed();
+}
+
+// Only ends the attempt. bWifiFastPath is still set, so the disconnect event does the fallback,
+// arming it here as well would start a second WiFi.begin() in the middle of the scan.
+// The event re-arms wifiReconnectTimer, which cancels the guard.
+void wifiFastTimeoutCB(uint32_t ulArg) {
+  if (WiFi.isConnected()) return;
+  LOG_WARN("[ wifiFastTimeoutCB ] No connection in %u ms", (uint32_t)NET_FAST_CONNECT_TIMEOUT_MS);
+  vTimerArm(&xTimerWheel, &wifiReconnectTimer, NET_FAST_CONNECT_TIMEOUT_MS, wifiFastGuardCB);
+  WiFi.disconnect();
+}
+
+void mqttReconnectCB(uint32_t ulArg) {
+  connectToMqtt();
 }
 
 void onWifiConnect(const WiFiEventStationModeGotIP& event) {
-  Serial.println("[ onWifiConnect ] Connected to Wi-Fi. Interface settings:");
-  Serial.print("\tIP:\t"); Serial.println(WiFi.localIP());
-  Serial.print("\tMASK:\t"); Serial.println(WiFi.subnetMask());
-  Serial.print("\tGW:\t"); Serial.println(WiFi.gatewayIP());
-  Serial.print("\tDNS:\t"); Serial.println(WiFi.dnsIP());
+  LOG_INFO("[ onWifiConnect ] Connected to Wi-Fi. IP %s, MASK %s", WiFi.localIP().toString().c_str(), WiFi.subnetMask().toString().c_str());
+  LOG_INFO("[ onWifiConnect ] GW %s, DNS %s", WiFi.gatewayIP().toString().c_str(), WiFi.dnsIP().toString().c_str());
+  vTimerCancel(&wifiReconnectTimer);
+  uiWifiAttempts = 0;
+  memcpy(xNetSession.pcBssid, WiFi.BSSID(), sizeof(xNetSession.pcBssid));
+  xNetSession.uiChannel = WiFi.channel();
+  xNetSession.ulIp = (uint32_t)WiFi.localIP();
+  xNetSession.ulGateway = (uint32_t)WiFi.gatewayIP();
+  xNetSession.ulMask = (uint32_t)WiFi.subnetMask();
+  xNetSession.ulDns = (uint32_t)WiFi.dnsIP();
+  xNetSession.uiFlags |= SESSION_WIFI;
+  vSessionSave(&xNetSession);
   if (pvNetEventCB) pvNetEventCB(NE_WIFI_CONNECTED);
 
   setupOTAServer();
@@ -63,36 +146,63 @@ void onWifiConnect(const WiFiEventStationModeGotIP& event) {
 }
 
 void onWifiDisconnect(const WiFiEventStationModeDisconnected& event) {
-  Serial.printf("[ onWifiDisconnect ] Disconnected from Wi-Fi (Reason: %i)\n", (int)event.reason);
-  mqttReconnectTimer.detach(); // ensure we don't reconnect to MQTT while reconnecting to Wi-Fi
-  wifiReconnectTimer.once(2, connectToWifi);
+  LOG_WARN("[ onWifiDisconnect ] Disconnected from Wi-Fi (Reason: %i)", (int)event.reason);
+  vTimerCancel(&mqttReconnectTimer); // ensure we don't reconnect to MQTT while reconnecting to Wi-Fi
   if (pvNetEventCB) pvNetEventCB(NE_WIFI_DISCONNECTED);
+  if (bWifiFastPath) {
+    wifiFastFailed();
+    return;
+  }
+  uint32_t ulDelayMs = ulNetBackoffMs(uiWifiAttempts);
+  if (uiWifiAttempts < 255) uiWifiAttempts++;
+  LOG_INFO("[ onWifiDisconnect ] Next attempt in %u ms", ulDelayMs);
+  vTimerArm(&xTimerWheel, &wifiReconnectTimer, ulDelayMs, wifiReconnectCB);
 }
 
 void connectToMqtt() {
-  Serial.println("[ connectToMqtt ] Connecting to MQTT...");
+  LOG_INFO("[ connectToMqtt ] Connecting to MQTT...");
   mqttClient.connect();
 }
 
 void onMqttConnect(bool sessionPresent) {
-    Serial.printf("[ onMqttConnect ] Connected to MQTT broker: %s:%d\n", mqttServer, mqttPort);
-    mqttClient.subscribe(mqttSetTopic, 1);
-    Serial.printf("[ onMqttConnect ] Subscribed to: %s\n", mqttSetTopic);
-    mqttClient.subscribe(mqttPingTopic, 1);
-    Serial.printf("[ onMqttConnect ] Subscribed to: %s\n", mqttPingTopic);
+    LOG_INFO("[ onMqttConnect ] Connected to MQTT broker: %s:%d", mqttServer, mqttPort);
+    uiMqttAttempts = 0;
+    bWifiFastPath = false;
+    bool bFirst = (ulBootMqttMs == 0);
+    if (bFirst) ulBootMqttMs = millis();
+    bMqttSessionPresent = NR_MQTT_PERSISTENT && sessionPresent;
+    if (bMqttSessionPresent && !bFirst) {
+        LOG_INFO("[ onMqttConnect ] Session present, subscriptions kept");
+    } else {
+        for (uint8_t i = 0; i < xTopicRouter.uiCount; i++) {
+            mqttClient.subscribe(xTopicRouter.pxRoutes[i].pcTopic, 1);
+            LOG_DEBUG("[ onMqttConnect ] Subscribed to: %s", xTopicRouter.pxRoutes[i].pcTopic);
+        }
+    }
+#if NR_MQTT_PERSISTENT
+    mqttClient.publish(NR_MQTT_AVAIL_TOPIC, 1, true, "online");
+#endif
     char cPayload[256];
-    sprintf(cPayload, "{\"connected\":true, \"device_id\":\"" NR_DEVICE_ID "\", \"device_alias\":\"" NR_DEVICE_ALIAS "\", \"ip_address\":\"%s\"}", WiFi.localIP().toString().c_str());
+    sprintf(cPayload, "{\"connected\":true, \"device_id\":\"" NR_DEVICE_ID "\", \"device_alias\":\"" NR_DEVICE_ALIAS "\", \"ip_address\":\"%s\", \"boot_mqtt_ms\":%u}", WiFi.localIP().toString().c_str(), ulBootMqttMs);
     mqttClient.publish(mqttReportTopic, 0, false, cPayload);
-    Serial.printf("[ onMqttConnect ] Welcome to %s\n", mqttReportTopic);
+    LOG_DEBUG("[ onMqttConnect ] Welcome to %s", mqttReportTopic);
     if (pvNetEventCB) pvNetEventCB(NE_MQTT_CONNECTED);
 
 }
 
 void onMqttDisconnect(AsyncMqttClientDisconnectReason reason) {
-  Serial.println("[ onMqttDisconnect ] Disconnected from MQTT.");
+  LOG_WARN("[ onMqttDisconnect ] Disconnected from MQTT.");
   
   if (WiFi.isConnected()) {
-    mqttReconnectTimer.once(2, connectToMqtt);
+    if (bWifiFastPath && uiMqttAttempts + 1 >= NET_FAST_MQTT_TRIES) {
+      uiMqttAttempts = 0;
+      WiFi.disconnect();    // onWifiDisconnect() drops the cached lease
+    } else {
+      uint32_t ulDelayMs = ulNetBackoffMs(uiMqttAttempts);
+      if (uiMqttAttempts < 255) uiMqttAttempts++;
+      LOG_INFO("[ onMqttDisconnect ] Next attempt in %u ms", ulDelayMs);
+      vTimerArm(&xTimerWheel, &mqttReconnectTimer, ulDelayMs, mqttReconnectCB);
+    }
   }
   if (pvNetEventCB) pvNetEventCB(NE_MQTT_DISCONNECTED);
 }
@@ -112,6 +222,7 @@ void onMqttDisconnect(AsyncMqttClientDisconnectReason reason) {
 // }
 
 void onMqttMessage(char* topic, char* payload, AsyncMqttClientMessageProperties properties, size_t len, size_t index, size_t total) {
+    PROFILE_SCOPE(PROF_MQTT_MESSAGE);
 //   Serial.println("Publish received.");
 //   Serial.print("  topic: ");
 //   Serial.println(topic);
@@ -127,33 +238,56 @@ void onMqttMessage(char* topic, char* payload, AsyncMqttClientMessageProperties
 //   Serial.println(index);
 //   Serial.print("  total: ");
 //   Serial.println(total);
-    if (len > 0) payload[len] = '\0';
-    // Serial.printf("[ MQTT ] Message received. %s => %s\n", topic, payload);
+    // Serial.printf("[ MQTT ] Message received. %s => %.*s\n", topic, len, payload);
+
+    const topic_route_t * pxRoute = pxRouterFind(&xTopicRouter, topic);
+    if (!pxRoute) return;
+    if (pxRoute->pvChunkCB) {
+        pxRoute->pvChunkCB(topic, payload, len, index, total);
+    } else if (bReasmFeed(&xMqttReasm, pxRoute, payload, len, index, total)) {
+        pxRoute->pvCB(topic, xMqttReasm.pcBuf, xMqttReasm.uiTotal);
+    } else if (index == 0 && total > MQTT_MESSAGE_MAX_LEN) {
+        LOG_WARN("[ onMqttMessage ] %s: %u bytes is too long, dropped", topic, total);
+    }
+}
 
+void onMqttPublish(uint16_t packetId) {
+    if (pvPublishAckCB) pvPublishAckCB(packetId);
+}
 
-    if (strcmp(topic, NR_MQTT_PING_TOPIC) == 0) {
-        // Serial.printf("[ MQTT ] Ping received. Payload:%s\n", payload);
-        if (pvPingCB) pvPingCB(topic, payload, len);
-    } else if (strcmp(topic, NR_MQTT_SET_TOPIC) == 0) {
-        // Serial.println("[ MQTT ] Command received.");
-        if (pvMessageCB) pvMessageCB(topic, payload, len);
+// Returns the QoS1 packet id, 0 if nothing was sent
+uint16_t vPublishReport(const char * pcReport, size_t len) {
+    vBenchOnPublish();
+    if (mqttClient.connected()) {
+        LOG_DEBUG("[ vPublishReport ] Publishing report...");
+        return mqttClient.publish(mqttReportTopic, 1, false, pcReport, len);
     }
+    return 0;
 }
 
-// void onMqttPublish(uint16_t packetId) {
-//   Serial.println("Publish acknowledged.");
-//   Serial.print("  packetId: ");
-//   Serial.println(packetId);
-// }
+// QoS0 and no log, for pongs and RTT probes. 0 if nothing was sent
+uint16_t vPublishLight(const char * pcTopic, const char * pcPayload, size_t len) {
+    if (!mqttClient.connected()) return 0;
+    return mqttClient.publish(pcTopic, 0, false, pcPayload, len);
+}
+
+// QoS1 retained, for state topics. 0 if nothing was sent
+uint16_t vPublishRetained(const char * pcTopic, const char * pcPayload) {
+    if (!mqttClient.connected()) return 0;
+    return mqttClient.publish(pcTopic, 1, true, pcPayload);
+}
 
-void vPublishReport(String &sReport) {
+#if NR_MQTT_BINARY
+void vPublishBinary(const uint8_t * pcFrame, size_t len) {
     if (mqttClient.connected()) {
-        Serial.printf("[ vPublishReport ] Publishing report...\n"); 
-        mqttClient.publish(mqttReportTopic, 1, false, sReport.c_str());
+        mqttClient.publish(mqttBinReportTopic, 1, false, (const char *)pcFrame, len);
     }
 }
+#endif
 
 void netSetup() {
+    WiFi.persistent(false);         // no flash write on every WiFi.begin()
+    WiFi.setAutoReconnect(false);   // retries are ours, with backoff
     wifiConnectHandler = WiFi.onStationModeGotIP(onWifiConnect);
     wifiDisconnectHandler = WiFi.onStationModeDisconnected(onWifiDisconnect);
 
@@ -162,13 +296,20 @@ void netSetup() {
     // mqttClient.onSubscribe(onMqttSubscribe);
     // mqttClient.onUnsubscribe(onMqttUnsubscribe);
     mqttClient.onMessage(onMqttMessage);
-    // mqttClient.onPublish(onMqttPublish);
+    mqttClient.onPublish(onMqttPublish);
     mqttClient.setServer(mqttServer, mqttPort);
     mqttClient.setCredentials(mqttUser, mqttPassword);
-    Serial.printf("[ netSetup ] Starting connectToWifi();\n");
+#if NR_MQTT_PERSISTENT
+    if (sizeof(NR_MQTT_CLIENT_ID) > 1) mqttClient.setClientId(NR_MQTT_CLIENT_ID);
+    mqttClient.setCleanSession(false);
+    mqttClient.setWill(NR_MQTT_AVAIL_TOPIC, 1, true, "offline");
+#endif
+    LOG_INFO("[ netSetup ] Starting connectToWifi();");
     connectToWifi();
 }
 
+// OTA callbacks run inside ArduinoOTA.handle(), which blocks loop() until the update is over,
+// so they write to Serial directly
 void setupOTAServer() {
   ArduinoOTA.setPassword(otaPassword);
   ArduinoOTA.onStart([]() {
@@ -202,9 +343,7 @@ void setupOTAServer() {
     }
   });
   ArduinoOTA.begin();
-  Serial.println("[ setupOTAServer ] Ready");
-  Serial.print("[ setupOTAServer ] IP address: ");
-  Serial.println(WiFi.localIP());
+  LOG_INFO("[ setupOTAServer ] Ready, IP address: %s", WiFi.localIP().toString().c_str());
 }
 
 void handleNetRoutine() {
@@ -0,0 +1,82 @@
+#ifndef NET_SESSION_H_
+#define NET_SESSION_H_
+#include <Arduino.h>
+#include <crc16.h>
+#include <rtc_layout.h>
+
+// What a restart needs to be back on the network fast, kept in RTC memory:
+// the last AP (BSSID + channel) and IP settings, so WiFi.begin() skips the scan and DHCP,
+// and the relay states, so a reset does not switch the lights off.
+// Retries use exponential backoff with jitter, so a building full of devices
+// coming back after a power blip does not hit the AP and the broker all at the same moment.
+
+#ifndef NET_BACKOFF_MIN_MS
+#define NET_BACKOFF_MIN_MS          500
+#endif
+#ifndef NET_BACKOFF_MAX_MS
+#define NET_BACKOFF_MAX_MS          60000
+#endif
+#define NET_FAST_CONNECT_TIMEOUT_MS 3000    // fast attempt not through by then: full scan
+#define NET_FAST_MQTT_TRIES         2       // broker unreachable over a fast link that often: lease is stale
+
+#define SESSION_MAGIC       0x53455353UL    // "SESS"
+#define SESSION_WIFI        BIT0            // AP and IP fields are valid
+#define SESSION_RELAYS      BIT1            // uiRelayStates is valid
+
+typedef struct {
+    uint32_t ulMagic;
+    uint8_t pcBssid[6];
+    uint8_t uiChannel;
+    uint8_t uiFlags;
+    uint32_t ulIp;
+    uint32_t ulGateway;
+    uint32_t ulMask;
+    uint32_t ulDns;
+    uint16_t uiRelayStates;     // bit N = relay N+1 is ON
+    uint16_t uiCrc;
+} net_session_t;
+
+static_assert(sizeof(net_session_t) <= RTC_SESSION_BLOCKS * RTC_BLOCK_SIZE, "session does not fit into its RTC area");
+
+uint16_t uiSessionCrc(const net_session_t * pxSession) {
+    return uiCrc16(pxSession, offsetof(net_session_t, uiCrc));
+}
+
+// Picks up the session of the previous run, false after a power cycle
+bool bSessionBegin(net_session_t * pxSession) {
+    if (ESP.rtcUserMemoryRead(RTC_SESSION_BLOCK, (uint32_t *)pxSession, sizeof(net_session_t))
+            && pxSession->ulMagic == SESSION_MAGIC && pxSession->uiCrc == uiSessionCrc(pxSession)) {
+        return true;
+    }
+    memset(pxSession, 0, sizeof(net_session_t));
+    pxSession->ulMagic = SESSION_MAGIC;
+    return false;
+}
+
+void vSessionSave(net_session_t * pxSession) {
+    pxSession->uiCrc = uiSessionCrc(pxSession);
+    ESP.rtcUserMemoryWrite(RTC_SESSION_BLOCK, (uint32_t *)pxSession, sizeof(net_session_t));
+}
+
+void vSessionSaveRelays(net_session_t * pxSession, uint16_t uiStates) {
+    if ((pxSession->uiFlags & SESSION_RELAYS) && pxSession->uiRelayStates == uiStates) return;
+    pxSession->uiRelayStates = uiStates;
+    pxSession->uiFlags |= SESSION_RELAYS;
+    vSessionSave(pxSession);
+}
+
+void vSessionForgetWifi(net_session_t * pxSession) {
+    if (!(pxSession->uiFlags & SESSION_WIFI)) return;
+    pxSession->uiFlags &= ~SESSION_WIFI;
+    vSessionSave(pxSession);
+}
+
+// Retry delay for the attempt number from 0: random in the upper half of min * 2^attempt,
+// capped at NET_BACKOFF_MAX_MS
+uint32_t ulNetBackoffMs(uint8_t uiAttempt) {
+    uint32_t ulCap = NET_BACKOFF_MAX_MS;
+    if (uiAttempt < 16 && ((uint32_t)NET_BACKOFF_MIN_MS << uiAttempt) < ulCap) ulCap = (uint32_t)NET_BACKOFF_MIN_MS << uiAttempt;
+    return ulCap / 2 + ESP.random() % (ulCap / 2 + 1);
+}
+
+#endif  // NET_SESSION_H_
@@ -0,0 +1,244 @@
+#ifndef OTA_ROUTINE_H_
+#define OTA_ROUTINE_H_
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <ESP8266HTTPClient.h>
+#include <Updater.h>
+#include <BearSSLHelpers.h>
+#include <heatshrink_decoder.h>
+#include <log_routine.h>
+
+// Pull OTA over HTTP, started with a command on NR_MQTT_OTA_TOPIC:
+//   {"url":"http://host/fw.bin.hs","size":412345,"md5":"<md5 of the image>","encoding":"heatshrink"}
+// size and md5 are those of the image as it lands in flash.
+//  - images must be signed with the private half of NR_OTA_PUBLIC_KEY, the MD5 only catches a broken
+//    download, not a forged command. public.key goes into NR_OTA_PUBLIC_KEY, the build refuses
+//    NR_OTA_HTTP without one:
+//      openssl genrsa -out private.key 2048 && openssl rsa -in private.key -pubout -out public.key
+//      python3 <core>/tools/signing.py --mode sign --privatekey private.key --bin fw.bin --out fw.bin.signed
+//  - "encoding":"heatshrink" images are unpacked on the fly, see heatshrink_decoder.h: sign, then compress.
+//    gzip images go to flash as they are, the eboot loader unpacks them: compress, then sign
+//    (size and md5 of the signed .gz then);
+//  - the Updater checks the signature and the MD5 in Update.end(), the boot switch is only written
+//    if both match;
+//  - a dropped connection or Wi-Fi resumes with a Range request from the last byte fed to the decoder,
+//    the decoder and the Updater keep their state meanwhile. OTA_MAX_RETRIES failures in a row give up;
+//  - the download runs from loop(), OTA_CHUNK_LEN bytes per pass, relays keep working in between.
+//    Only the (re)connect blocks: DNS, TCP connect and the response headers may each take up to
+//    OTA_CONNECT_TIMEOUT_MS. Button edges are latched by the ISR and commands queue up meanwhile,
+//    both are handled on the pass after it.
+
+#ifndef NR_OTA_HTTP
+#define NR_OTA_HTTP false
+#endif
+#ifndef NR_OTA_PUBLIC_KEY
+#define NR_OTA_PUBLIC_KEY ""
+#endif
+#ifndef NR_MQTT_OTA_TOPIC
+#define NR_MQTT_OTA_TOPIC NR_MQTT_SET_TOPIC "/ota"
+#endif
+#ifndef OTA_CHUNK_LEN
+#define OTA_CHUNK_LEN       1024
+#endif
+#ifndef OTA_STALL_MS
+#define OTA_STALL_MS        10000       // no data this long: reconnect and resume
+#endif
+#ifndef OTA_CONNECT_TIMEOUT_MS
+#define OTA_CONNECT_TIMEOUT_MS  800     // per blocking step of a (re)connect, see above
+#endif
+#ifndef OTA_RETRY_MS
+#define OTA_RETRY_MS        3000
+#endif
+#ifndef OTA_MAX_RETRIES
+#define OTA_MAX_RETRIES     20
+#endif
+#define OTA_URL_LEN         160
+
+typedef enum {
+    OTA_IDLE = 0,
+    OTA_CONNECT,
+    OTA_RECEIVE,
+    OTA_WAIT_RETRY,
+    OTA_DONE,           // verified, reboot to run it
+    OTA_FAILED
+} ota_state_t;
+
+typedef struct {
+    ota_state_t xState;
+    char pcUrl[OTA_URL_LEN];
+    char pcMd5[33];
+    bool bHeatshrink;
+    uint32_t ulImageSize;       // as written to flash
+    uint32_t ulReceived;        // download bytes fed so far, a resume starts here
+    uint32_t ulTotal;           // download length, known after the first response
+    uint32_t ulStartedAt;
+    uint32_t ulFinishedAt;
+    uint32_t ulLastDataAt;
+    uint32_t ulRetryAt;
+    uint8_t uiRetries;          // failures since the last data
+    uint16_t uiResumes;
+    const char * pcError;
+    int iErrorCode;             // HTTP status or Updater error
+    hs_decoder_t xDecoder;
+} ota_t;
+
+#if NR_OTA_HTTP
+
+static_assert(sizeof(NR_OTA_PUBLIC_KEY) - 1 >= 64, "NR_OTA_PUBLIC_KEY must be set, PEM of the image signing key");
+
+WiFiClient xOtaClient;
+HTTPClient xOtaHttp;
+BearSSL::PublicKey xOtaSignKey(NR_OTA_PUBLIC_KEY);
+BearSSL::HashSHA256 xOtaSignHash;
+BearSSL::SigningVerifier xOtaSignVerifier(&xOtaSignKey);
+uint8_t pcOtaChunk[OTA_CHUNK_LEN];
+
+bool bOtaBusy(const ota_t * pxOta) {
+    return pxOta->xState == OTA_CONNECT || pxOta->xState == OTA_RECEIVE || pxOta->xState == OTA_WAIT_RETRY;
+}
+
+// Only records the job, the Updater and the connection are set up from loop()
+bool bOtaStart(ota_t * pxOta, const char * pcUrl, size_t uiUrlLen, uint32_t ulImageSize, const char * pcMd5, bool bHeatshrink) {
+    if (bOtaBusy(pxOta) || uiUrlLen == 0 || uiUrlLen >= OTA_URL_LEN || ulImageSize == 0) return false;
+    memset(pxOta, 0, offsetof(ota_t, xDecoder));
+    memcpy(pxOta->pcUrl, pcUrl, uiUrlLen);
+    pxOta->pcUrl[uiUrlLen] = '\0';
+    memcpy(pxOta->pcMd5, pcMd5, 32);
+    pxOta->pcMd5[32] = '\0';
+    pxOta->bHeatshrink = bHeatshrink;
+    pxOta->ulImageSize = ulImageSize;
+    pxOta->ulStartedAt = millis();
+    pxOta->xState = OTA_CONNECT;
+    return true;
+}
+
+void vOtaFail(ota_t * pxOta, const char * pcError, int iErrorCode) {
+    xOtaHttp.end();
+    if (Update.isRunning()) Update.end();     // short of the size: resets without touching the boot
+    pxOta->pcError = pcError;
+    pxOta->iErrorCode = iErrorCode;
+    pxOta->ulFinishedAt = millis();
+    pxOta->xState = OTA_FAILED;
+    LOG_ERROR("[ vOtaFail ] %s (%d) at %u bytes", pcError, iErrorCode, pxOta->ulReceived);
+}
+
+void vOtaRetry(ota_t * pxOta, const char * pcWhy) {
+    xOtaHttp.end();
+    if (++pxOta->uiRetries > OTA_MAX_RETRIES) {
+        vOtaFail(pxOta, "retries", pxOta->uiRetries - 1);
+        return;
+    }
+    LOG_WARN("[ vOtaRetry ] %s at %u bytes, retry %i", pcWhy, pxOta->ulReceived, pxOta->uiRetries);
+    pxOta->ulRetryAt = millis();
+    pxOta->xState = OTA_WAIT_RETRY;
+}
+
+bool bOtaWrite(const uint8_t * pcData, size_t len, void * pvCtx) {
+    return Update.write((uint8_t *)pcData, len) == len;
+}
+
+void vOtaConnect(ota_t * pxOta) {
+    if (!Update.isRunning()) {
+        if (!xOtaSignKey.isRSA() && !xOtaSignKey.isEC()) {
+            vOtaFail(pxOta, "signing key", 0);
+            return;
+        }
+        Update.installSignature(&xOtaSignHash, &xOtaSignVerifier);
+        if (!Update.begin(pxOta->ulImageSize)) {
+            vOtaFail(pxOta, "begin", Update.getError());
+            return;
+        }
+        Update.setMD5(pxOta->pcMd5);
+        vHsBegin(&pxOta->xDecoder);
+    }
+    if (!xOtaHttp.begin(xOtaClient, pxOta->pcUrl)) {
+        vOtaFail(pxOta, "url", 0);
+        return;
+    }
+    xOtaHttp.setTimeout(OTA_CONNECT_TIMEOUT_MS);   // also the DNS and TCP connect timeout of the client
+    if (pxOta->ulReceived) {
+        char pcRange[24];
+        snprintf(pcRange, sizeof(pcRange), "bytes=%u-", pxOta->ulReceived);
+        xOtaHttp.addHeader("Range", pcRange);
+    }
+    int iCode = xOtaHttp.GET();
+    if (iCode < 0) {
+        vOtaRetry(pxOta, "connect");
+        return;
+    }
+    if (iCode != (pxOta->ulReceived ? HTTP_CODE_PARTIAL_CONTENT : HTTP_CODE_OK)) {
+        vOtaFail(pxOta, pxOta->ulReceived && iCode == HTTP_CODE_OK ? "no range support" : "http", iCode);
+        return;
+    }
+    int iSize = xOtaHttp.getSize();
+    if (iSize <= 0) {
+        vOtaFail(pxOta, "no length", iSize);
+        return;
+    }
+    if (pxOta->ulReceived) pxOta->uiResumes++;
+    pxOta->ulTotal = pxOta->ulReceived + iSize;
+    pxOta->ulLastDataAt = millis();
+    pxOta->xState = OTA_RECEIVE;
+    LOG_INFO("[ vOtaConnect ] %u of %u bytes to go", (uint32_t)iSize, pxOta->ulTotal);
+}
+
+void vOtaReceive(ota_t * pxOta) {
+    WiFiClient * pxStream = xOtaHttp.getStreamPtr();
+    size_t uiAvail = pxStream ? pxStream->available() : 0;
+    if (uiAvail) {
+        size_t uiLen = pxStream->read(pcOtaChunk, min(uiAvail, sizeof(pcOtaChunk)));
+        uiLen = min(uiLen, (size_t)(pxOta->ulTotal - pxOta->ulReceived));
+        bool bOk = pxOta->bHeatshrink ? bHsFeed(&pxOta->xDecoder, pcOtaChunk, uiLen, bOtaWrite, NULL)
+                                      : bOtaWrite(pcOtaChunk, uiLen, NULL);
+        if (!bOk) {
+            vOtaFail(pxOta, "write", Update.getError());
+            return;
+        }
+        pxOta->ulReceived += uiLen;
+        pxOta->ulLastDataAt = millis();
+        pxOta->uiRetries = 0;
+    } else if (!pxStream || !pxStream->connected()) {
+        vOtaRetry(pxOta, "connection lost");
+        return;
+    } else if (millis() - pxOta->ulLastDataAt >= OTA_STALL_MS) {
+        vOtaRetry(pxOta, "stalled");
+        return;
+    }
+    if (pxOta->ulReceived < pxOta->ulTotal) return;
+    xOtaHttp.end();
+    if (!Update.end()) {    // size, signature and MD5 checked here
+        vOtaFail(pxOta, "verify", Update.getError());
+        return;
+    }
+    pxOta->ulFinishedAt = millis();
+    pxOta->xState = OTA_DONE;
+    LOG_INFO("[ vOtaReceive ] Image verified, %u bytes in %u ms", pxOta->ulReceived, pxOta->ulFinishedAt - pxOta->ulStartedAt);
+}
+
+// Called from loop(), one step per pass
+ota_state_t xOtaRun(ota_t * pxOta) {
+    switch (pxOta->xState) {
+    case OTA_WAIT_RETRY:
+        if (millis() - pxOta->ulRetryAt >= OTA_RETRY_MS && WiFi.isConnected()) pxOta->xState = OTA_CONNECT;
+        break;
+    case OTA_CONNECT:
+        if (WiFi.isConnected()) vOtaConnect(pxOta);
+        break;
+    case OTA_RECEIVE:
+        vOtaReceive(pxOta);
+        break;
+    default:
+        break;
+    }
+    return pxOta->xState;
+}
+
+// Download bytes per second, over the whole job including retries
+uint32_t ulOtaThroughput(const ota_t * pxOta) {
+    uint32_t ulMs = pxOta->ulFinishedAt - pxOta->ulStartedAt;
+    return ulMs ? (uint64_t)pxOta->ulReceived * 1000 / ulMs : 0;
+}
+
+#endif  // NR_OTA_HTTP
+
+#endif  // OTA_ROUTINE_H_
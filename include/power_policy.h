@@ -0,0 +1,125 @@
+#ifndef POWER_POLICY_H_
+#define POWER_POLICY_H_
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+#include <coredecls.h>
+
+// Idle power policy. After POWER_MODEM_AFTER_MS without activity the radio goes to modem sleep
+// (wakes every DTIM), after POWER_LIGHT_AFTER_MS to automatic light sleep (every POWER_LISTEN_INTERVAL
+// DTIMs, CPU clock gated in between). loop() idles in esp_delay() slices meanwhile, so the SDK can
+// actually sleep. Any command, button edge or pending work puts it back to full power at once:
+// vPowerWake() from SYS context ends the slice early, buttons wake the chip over GPIO.
+// Per-state residency and the worst event-to-actuation time by the state the event found are kept
+// for the "POWER" report.
+
+#ifndef NR_POWER_POLICY
+#define NR_POWER_POLICY false
+#endif
+#ifndef POWER_MODEM_AFTER_MS
+#define POWER_MODEM_AFTER_MS    2000
+#endif
+#ifndef POWER_LIGHT_AFTER_MS
+#define POWER_LIGHT_AFTER_MS    30000
+#endif
+#ifndef POWER_LISTEN_INTERVAL
+#define POWER_LISTEN_INTERVAL   3       // DTIMs between wakeups in light sleep, 1..10
+#endif
+#define POWER_MODEM_SLICE_MS    20
+#define POWER_LIGHT_SLICE_MS    500     // cut short at the next timer wheel deadline
+
+typedef enum {
+    PWR_ACTIVE = 0,
+    PWR_MODEM,
+    PWR_LIGHT,
+    PWR_STATES_COUNT
+} power_state_t;
+
+const char * const pcPowerStateNames[PWR_STATES_COUNT] = { "active", "modem", "light" };
+
+typedef struct {
+    power_state_t xState;
+    power_state_t xPrevState;
+    uint32_t ulStateSince;
+    uint32_t ulLastActivityMs;
+    volatile bool bWake;        // set from SYS context, ends the idle slice
+    uint32_t ulResidencyMs[PWR_STATES_COUNT];
+    uint32_t ulTransitions;
+    uint32_t ulWakeLatencyMaxMs[PWR_STATES_COUNT];  // event to actuation, by the state at the event
+} power_policy_t;
+
+typedef bool (*bPowerWakeCheck_t)();    // true: there is work, stop idling
+
+void vPowerBegin(power_policy_t * pxPower) {
+    memset(pxPower, 0, sizeof(power_policy_t));
+    pxPower->ulStateSince = millis();
+    pxPower->ulLastActivityMs = pxPower->ulStateSince;
+    WiFi.setSleepMode(WIFI_NONE_SLEEP);
+}
+
+// Something came in (SYS context or loop()), not from an ISR
+void vPowerWake(power_policy_t * pxPower) {
+    pxPower->bWake = true;
+    esp_schedule();
+}
+
+// State the device was in at ulAtMs, as long as that is no more than one change ago
+power_state_t xPowerStateAt(const power_policy_t * pxPower, uint32_t ulAtMs) {
+    return (int32_t)(ulAtMs - pxPower->ulStateSince) < 0 ? pxPower->xPrevState : pxPower->xState;
+}
+
+void vPowerActuated(power_policy_t * pxPower, power_state_t xStateAtEvent, uint32_t ulLatencyMs) {
+    if (ulLatencyMs > pxPower->ulWakeLatencyMaxMs[xStateAtEvent]) pxPower->ulWakeLatencyMaxMs[xStateAtEvent] = ulLatencyMs;
+}
+
+power_state_t xPowerTarget(power_policy_t * pxPower, bool bBusy, uint32_t ulNow) {
+    if (bBusy) pxPower->ulLastActivityMs = ulNow;
+    uint32_t ulIdleMs = ulNow - pxPower->ulLastActivityMs;
+    if (ulIdleMs >= POWER_LIGHT_AFTER_MS) return PWR_LIGHT;
+    if (ulIdleMs >= POWER_MODEM_AFTER_MS) return PWR_MODEM;
+    return PWR_ACTIVE;
+}
+
+void vPowerSet(power_policy_t * pxPower, power_state_t xState, uint32_t ulNow) {
+    pxPower->ulResidencyMs[pxPower->xState] += ulNow - pxPower->ulStateSince;
+    pxPower->ulStateSince = ulNow;
+    pxPower->xPrevState = pxPower->xState;
+    pxPower->xState = xState;
+    pxPower->ulTransitions++;
+    switch (xState) {
+    case PWR_ACTIVE:
+        WiFi.setSleepMode(WIFI_NONE_SLEEP);
+        break;
+    case PWR_MODEM:
+        WiFi.setSleepMode(WIFI_MODEM_SLEEP, 0);
+        break;
+    case PWR_LIGHT:
+        WiFi.setSleepMode(WIFI_LIGHT_SLEEP, POWER_LISTEN_INTERVAL);
+        break;
+    default:
+        break;
+    }
+}
+
+// Time spent in a state so far, the current stay included
+uint32_t ulPowerResidencyMs(const power_policy_t * pxPower, power_state_t xState, uint32_t ulNow) {
+    uint32_t ulMs = pxPower->ulResidencyMs[xState];
+    if (xState == pxPower->xState) ulMs += ulNow - pxPower->ulStateSince;
+    return ulMs;
+}
+
+// Gives the CPU to the SDK for one slice of the current state, or less if work comes in.
+// ulMaxMs ends it early for a deadline, e.g. the next timer wheel one: blink and auto-off keep their time
+void vPowerIdle(const power_policy_t * pxPower, bPowerWakeCheck_t pvWakeCheck, uint32_t ulMaxMs) {
+    switch (pxPower->xState) {
+    case PWR_MODEM:
+        esp_delay(min((uint32_t)POWER_MODEM_SLICE_MS, ulMaxMs), [pvWakeCheck]() { return !pvWakeCheck(); });
+        break;
+    case PWR_LIGHT:
+        esp_delay(min((uint32_t)POWER_LIGHT_SLICE_MS, ulMaxMs), [pvWakeCheck]() { return !pvWakeCheck(); });
+        break;
+    default:
+        break;
+    }
+}
+
+#endif  // POWER_POLICY_H_
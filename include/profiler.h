@@ -0,0 +1,84 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+#include <Arduino.h>
+
+// Hot path profiler. PROFILE_SCOPE(id) measures the rest of the enclosing block with the CPU cycle
+// counter: calls, min/avg/max and a log2 histogram (bucket N counts calls of 2^N..2^(N+1)-1 us,
+// the last one everything longer). Also tracks the free heap low-water mark.
+// Open it after a handler's early returns: loop() passes with nothing to do would swamp the numbers.
+// Compiled out when NR_PROFILER is false.
+
+#ifndef NR_PROFILER
+#define NR_PROFILER true
+#endif
+
+#define PROF_BUCKETS    16
+
+typedef enum {
+    PROF_MESSAGE_CB = 0,
+    PROF_PING_CB,
+    PROF_STATE_REPORT,
+    PROF_READ_BUTTONS,
+    PROF_RELAY_COMMAND,
+    PROF_MQTT_MESSAGE,
+    PROF_SLOTS_COUNT
+} prof_slot_id_t;
+
+const char * const pcProfSlotNames[PROF_SLOTS_COUNT] = {
+    "vMessageCB", "vPingCB", "vStateReportHandler", "vButtonsHandler", "vRelayCommandScheduledHandler", "onMqttMessage"
+};
+
+typedef struct {
+    uint32_t ulCalls;
+    uint32_t ulMinCycles;
+    uint32_t ulMaxCycles;
+    uint64_t ullSumCycles;
+    uint32_t ulHist[PROF_BUCKETS];
+} prof_slot_t;
+
+#if NR_PROFILER
+
+prof_slot_t xProfSlots[PROF_SLOTS_COUNT];
+uint32_t ulProfHeapLow = UINT32_MAX;
+
+void vProfSampleHeap() {
+    uint32_t ulFree = ESP.getFreeHeap();
+    if (ulFree < ulProfHeapLow) ulProfHeapLow = ulFree;
+}
+
+uint32_t ulProfCyclesToUs(uint32_t ulCycles) {
+    return ulCycles / ESP.getCpuFreqMHz();
+}
+
+void vProfAdd(prof_slot_id_t xId, uint32_t ulCycles) {
+    prof_slot_t * pxSlot = &xProfSlots[xId];
+    if (pxSlot->ulCalls == 0 || ulCycles < pxSlot->ulMinCycles) pxSlot->ulMinCycles = ulCycles;
+    if (ulCycles > pxSlot->ulMaxCycles) pxSlot->ulMaxCycles = ulCycles;
+    pxSlot->ullSumCycles += ulCycles;
+    pxSlot->ulCalls++;
+    uint32_t ulUs = ulProfCyclesToUs(ulCycles);
+    uint8_t uiBucket = 0;
+    while (ulUs > 1 && uiBucket < PROF_BUCKETS - 1) {
+        ulUs >>= 1;
+        uiBucket++;
+    }
+    pxSlot->ulHist[uiBucket]++;
+    vProfSampleHeap();
+}
+
+struct prof_scope_t {
+    prof_slot_id_t xId;
+    uint32_t ulStart;
+    prof_scope_t(prof_slot_id_t xSlot) : xId(xSlot), ulStart(ESP.getCycleCount()) {}
+    ~prof_scope_t() { vProfAdd(xId, ESP.getCycleCount() - ulStart); }
+};
+
+#define PROFILE_SCOPE(id)   prof_scope_t xProfScope(id)
+
+#else
+
+#define PROFILE_SCOPE(id)
+
+#endif  // NR_PROFILER
+
+#endif  // PROFILER_H_
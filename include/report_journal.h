@@ -0,0 +1,159 @@
+#ifndef REPORT_JOURNAL_H_
+#define REPORT_JOURNAL_H_
+#include <Arduino.h>
+#include <rtc_layout.h>
+#include <report_writer.h>
+
+// Offline journal. While the broker is unreachable every state event is stored in a fixed ring
+// with a sequence number and a timestamp, after reconnect the whole ring goes out in one
+// {"journal":[[seq,type,data,time,uptime],...],"lost":N} report and is cleared on PUBACK.
+// Sequence numbers are continuous across outages (mod 65536), so the backend can see gaps.
+// time is unix seconds, or seconds since boot (uptime = 1) if the clock was not set yet.
+// With NR_JOURNAL_RTC the ring is mirrored to RTC memory and survives a reset.
+
+#ifndef NR_JOURNAL_RTC
+#define NR_JOURNAL_RTC true
+#endif
+
+#define JOURNAL_SIZE        24
+#define JOURNAL_MAGIC       0x4A524E32UL    // "JRN2"
+#define JOURNAL_UPTIME      0x80            // uiType flag: ulTime is seconds since boot
+// Longest possible replay report
+#define JOURNAL_REPORT_LEN  (sizeof("{\"journal\":[],\"lost\":65535}") + JOURNAL_SIZE * sizeof("[65535,127,65535,4294967295,1],"))
+
+typedef enum {
+    JE_RELAYS = 1,      // uiData: relay states, bit N = relay N+1 is ON
+    JE_BUTTON           // uiData: button index << 4 | gesture
+} journal_event_type_t;
+
+typedef struct {
+    uint16_t uiSeq;
+    uint8_t uiType;
+    uint8_t uiReserved;
+    uint32_t ulTime;
+    uint16_t uiData;
+    uint16_t uiReserved2;
+} journal_event_t;
+
+typedef struct {
+    uint32_t ulMagic;
+    uint16_t uiNextSeq;
+    uint8_t uiHead;         // oldest event
+    uint8_t uiCount;
+    uint16_t uiLost;        // overwritten because the ring was full
+    uint16_t uiReserved;
+} journal_header_t;
+
+typedef struct {
+    journal_header_t xHeader;
+    journal_event_t xEvents[JOURNAL_SIZE];
+    uint16_t uiReplayPacketId;
+    uint8_t uiReplayCount;
+    uint16_t uiReplayEndSeq;    // uiNextSeq when the replay was written: it holds the events before it
+    uint16_t uiReplayLost;      // uiLost it reported
+} journal_t;
+
+static_assert(sizeof(journal_header_t) + sizeof(journal_event_t) * JOURNAL_SIZE <= RTC_JOURNAL_BLOCKS * RTC_BLOCK_SIZE, "journal does not fit into its RTC area");
+
+void vJournalSaveHeader(journal_t * pxJournal) {
+#if NR_JOURNAL_RTC
+    ESP.rtcUserMemoryWrite(RTC_JOURNAL_BLOCK, (uint32_t *)&pxJournal->xHeader, sizeof(journal_header_t));
+#endif
+}
+
+void vJournalSaveEvent(journal_t * pxJournal, uint8_t uiIdx) {
+#if NR_JOURNAL_RTC
+    uint32_t ulBlock = RTC_JOURNAL_BLOCK + (sizeof(journal_header_t) + uiIdx * sizeof(journal_event_t)) / RTC_BLOCK_SIZE;
+    ESP.rtcUserMemoryWrite(ulBlock, (uint32_t *)&pxJournal->xEvents[uiIdx], sizeof(journal_event_t));
+#endif
+}
+
+// Picks up the journal left by the previous run, if any
+void vJournalBegin(journal_t * pxJournal) {
+    memset(pxJournal, 0, sizeof(journal_t));
+    pxJournal->xHeader.ulMagic = JOURNAL_MAGIC;
+#if NR_JOURNAL_RTC
+    journal_header_t xSaved;
+    if (ESP.rtcUserMemoryRead(RTC_JOURNAL_BLOCK, (uint32_t *)&xSaved, sizeof(xSaved))
+            && xSaved.ulMagic == JOURNAL_MAGIC && xSaved.uiHead < JOURNAL_SIZE && xSaved.uiCount <= JOURNAL_SIZE) {
+        pxJournal->xHeader = xSaved;
+        ESP.rtcUserMemoryRead(RTC_JOURNAL_BLOCK + sizeof(journal_header_t) / RTC_BLOCK_SIZE,
+                              (uint32_t *)pxJournal->xEvents, sizeof(pxJournal->xEvents));
+        return;
+    }
+    vJournalSaveHeader(pxJournal);
+#endif
+}
+
+// The event went out with the replay that waits for its PUBACK
+bool bJournalReplayed(const journal_t * pxJournal, const journal_event_t * pxEvent) {
+    return pxJournal->uiReplayPacketId != 0 && (int16_t)(pxEvent->uiSeq - pxJournal->uiReplayEndSeq) < 0;
+}
+
+void vJournalAppend(journal_t * pxJournal, journal_event_type_t xType, uint16_t uiData, uint32_t ulTime, bool bUptime) {
+    journal_header_t * pxHeader = &pxJournal->xHeader;
+    uint8_t uiIdx = (pxHeader->uiHead + pxHeader->uiCount) % JOURNAL_SIZE;
+    if (pxHeader->uiCount == JOURNAL_SIZE) {    // full, the oldest event goes
+        if (!bJournalReplayed(pxJournal, &pxJournal->xEvents[pxHeader->uiHead])) pxHeader->uiLost++;
+        pxHeader->uiHead = (pxHeader->uiHead + 1) % JOURNAL_SIZE;
+    } else {
+        pxHeader->uiCount++;
+    }
+    journal_event_t * pxEvent = &pxJournal->xEvents[uiIdx];
+    pxEvent->uiSeq = pxHeader->uiNextSeq++;
+    pxEvent->uiType = xType | (bUptime ? JOURNAL_UPTIME : 0);
+    pxEvent->uiData = uiData;
+    pxEvent->ulTime = ulTime;
+    vJournalSaveEvent(pxJournal, uiIdx);
+    vJournalSaveHeader(pxJournal);
+}
+
+// Writes the replay report, returns its length or 0 if there is nothing to replay
+size_t uiJournalFormat(journal_t * pxJournal, char * pcBuf, size_t uiSize) {
+    journal_header_t * pxHeader = &pxJournal->xHeader;
+    if (pxHeader->uiCount == 0 && pxHeader->uiLost == 0) return 0;
+    report_writer_t xReport;
+    vReportBegin(&xReport, pcBuf, uiSize);
+    vReportPutKey(&xReport, "journal");
+    vReportPutChar(&xReport, '[');
+    for (uint8_t i = 0; i < pxHeader->uiCount; i++) {
+        const journal_event_t * pxEvent = &pxJournal->xEvents[(pxHeader->uiHead + i) % JOURNAL_SIZE];
+        if (i) vReportPutChar(&xReport, ',');
+        vReportPutChar(&xReport, '[');
+        vReportPutUInt(&xReport, pxEvent->uiSeq);
+        vReportPutChar(&xReport, ',');
+        vReportPutUInt(&xReport, pxEvent->uiType & ~JOURNAL_UPTIME);
+        vReportPutChar(&xReport, ',');
+        vReportPutUInt(&xReport, pxEvent->uiData);
+        vReportPutChar(&xReport, ',');
+        vReportPutUInt(&xReport, pxEvent->ulTime);
+        vReportPutRaw(&xReport, (pxEvent->uiType & JOURNAL_UPTIME) ? ",1]" : ",0]", 3);
+    }
+    vReportPutChar(&xReport, ']');
+    vReportAddInt(&xReport, "lost", pxHeader->uiLost);
+    pxJournal->uiReplayCount = pxHeader->uiCount;
+    pxJournal->uiReplayEndSeq = pxHeader->uiNextSeq;
+    pxJournal->uiReplayLost = pxHeader->uiLost;
+    return uiReportEnd(&xReport);
+}
+
+void vJournalReplaySent(journal_t * pxJournal, uint16_t uiPacketId) {
+    pxJournal->uiReplayPacketId = uiPacketId;
+}
+
+// PUBACK for the replay: what is left of the replayed events can go, an overflow since may
+// have dropped some of them already. Events added since then stay, and so does their lost count.
+bool bJournalAck(journal_t * pxJournal, uint16_t uiPacketId) {
+    if (pxJournal->uiReplayPacketId == 0 || pxJournal->uiReplayPacketId != uiPacketId) return false;
+    journal_header_t * pxHeader = &pxJournal->xHeader;
+    while (pxHeader->uiCount && bJournalReplayed(pxJournal, &pxJournal->xEvents[pxHeader->uiHead])) {
+        pxHeader->uiHead = (pxHeader->uiHead + 1) % JOURNAL_SIZE;
+        pxHeader->uiCount--;
+    }
+    pxHeader->uiLost -= min(pxHeader->uiLost, pxJournal->uiReplayLost);
+    pxJournal->uiReplayPacketId = 0;
+    vJournalSaveHeader(pxJournal);
+    return true;
+}
+
+#endif  // REPORT_JOURNAL_H_
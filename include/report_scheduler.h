@@ -0,0 +1,110 @@
+#ifndef REPORT_SCHEDULER_H_
+#define REPORT_SCHEDULER_H_
+#include <Arduino.h>
+
+// Bookkeeping for outgoing state reports:
+//  - when the pipe is idle a report goes out on the next loop() pass,
+//    after that, changes are merged until REPORT_COALESCE_MS since the last publish has passed;
+//  - no more than REPORT_MAX_INFLIGHT QoS1 reports wait for PUBACK at any time;
+//  - every in-flight report remembers which relays it carried and their values,
+//    so on PUBACK they become the "last acknowledged" state;
+//  - the next delta is computed against the newest value sent, in flight or acknowledged.
+//    A report that is dropped or times out makes its relays unknown again, so they are resent.
+
+#ifndef REPORT_COALESCE_MS
+#define REPORT_COALESCE_MS      250
+#endif
+#ifndef REPORT_MAX_INFLIGHT
+#define REPORT_MAX_INFLIGHT     4
+#endif
+#ifndef REPORT_ACK_TIMEOUT_MS
+#define REPORT_ACK_TIMEOUT_MS   10000
+#endif
+
+typedef struct {
+    uint16_t uiPacketId;        // 0 = free slot
+    uint16_t uiRelayMask;       // relays carried by the report
+    uint16_t uiRelayStates;     // and their values, 1 = ON
+    uint32_t ulSentAt;
+} report_inflight_t;
+
+typedef struct {
+    report_inflight_t xInflight[REPORT_MAX_INFLIGHT];
+    uint8_t uiInflight;
+    uint16_t uiAckedStates;     // last acknowledged relay values, 1 = ON
+    uint16_t uiAckedMask;       // relays whose value was ever acknowledged
+    uint16_t uiSentStates;      // newest value sent, acknowledged or still in flight
+    uint16_t uiSentMask;        // relays whose newest value is acknowledged or in flight
+    uint32_t ulLastSentAt;
+    bool bSentOnce;
+    uint32_t ulPublished;
+    uint32_t ulAckTimeouts;
+} report_scheduler_t;
+
+void vReportSchedExpire(report_scheduler_t * pxSched, uint32_t ulNow) {
+    for (uint8_t i = 0; i < REPORT_MAX_INFLIGHT; i++) {
+        report_inflight_t * pxSlot = &pxSched->xInflight[i];
+        if (pxSlot->uiPacketId == 0 || ulNow - pxSlot->ulSentAt < REPORT_ACK_TIMEOUT_MS) continue;
+        pxSlot->uiPacketId = 0;
+        pxSched->uiInflight--;
+        pxSched->ulAckTimeouts++;
+        pxSched->uiSentMask &= ~pxSlot->uiRelayMask;    // may never have arrived
+    }
+}
+
+// Drops every in-flight report, e.g. on disconnect: those PUBACKs will never come
+void vReportSchedReset(report_scheduler_t * pxSched) {
+    for (uint8_t i = 0; i < REPORT_MAX_INFLIGHT; i++) pxSched->xInflight[i].uiPacketId = 0;
+    pxSched->uiInflight = 0;
+    pxSched->uiSentStates = pxSched->uiAckedStates;
+    pxSched->uiSentMask = pxSched->uiAckedMask;
+}
+
+// Is it time to publish a pending report?
+bool bReportSchedReady(report_scheduler_t * pxSched, uint32_t ulNow) {
+    vReportSchedExpire(pxSched, ulNow);
+    if (pxSched->uiInflight >= REPORT_MAX_INFLIGHT) return false;
+    return !pxSched->bSentOnce || ulNow - pxSched->ulLastSentAt >= REPORT_COALESCE_MS;
+}
+
+// Does the backend have this relay value, or is it on the way there?
+bool bReportSchedKnown(const report_scheduler_t * pxSched, uint8_t uiRelayIdx, bool bOn) {
+    uint16_t uiBit = 1 << uiRelayIdx;
+    return (pxSched->uiSentMask & uiBit) && (((pxSched->uiSentStates & uiBit) != 0) == bOn);
+}
+
+void vReportSchedSent(report_scheduler_t * pxSched, uint16_t uiPacketId, uint16_t uiRelayMask, uint16_t uiRelayStates, uint32_t ulNow) {
+    pxSched->ulLastSentAt = ulNow;
+    pxSched->bSentOnce = true;
+    pxSched->ulPublished++;
+    if (uiPacketId == 0) return;
+    pxSched->uiSentStates = (pxSched->uiSentStates & ~uiRelayMask) | (uiRelayStates & uiRelayMask);
+    pxSched->uiSentMask |= uiRelayMask;
+    for (uint8_t i = 0; i < REPORT_MAX_INFLIGHT; i++) {
+        report_inflight_t * pxSlot = &pxSched->xInflight[i];
+        if (pxSlot->uiPacketId != 0) continue;
+        pxSlot->uiPacketId = uiPacketId;
+        pxSlot->uiRelayMask = uiRelayMask;
+        pxSlot->uiRelayStates = uiRelayStates;
+        pxSlot->ulSentAt = ulNow;
+        pxSched->uiInflight++;
+        return;
+    }
+}
+
+// PUBACK arrived, true with the publish time of the report. Unknown ids (not a state report) are ignored.
+bool bReportSchedAck(report_scheduler_t * pxSched, uint16_t uiPacketId, uint32_t * pulSentAt) {
+    for (uint8_t i = 0; i < REPORT_MAX_INFLIGHT; i++) {
+        report_inflight_t * pxSlot = &pxSched->xInflight[i];
+        if (pxSlot->uiPacketId != uiPacketId) continue;
+        pxSched->uiAckedStates = (pxSched->uiAckedStates & ~pxSlot->uiRelayMask) | (pxSlot->uiRelayStates & pxSlot->uiRelayMask);
+        pxSched->uiAckedMask |= pxSlot->uiRelayMask;
+        pxSlot->uiPacketId = 0;
+        pxSched->uiInflight--;
+        *pulSentAt = pxSlot->ulSentAt;
+        return true;
+    }
+    return false;
+}
+
+#endif  // REPORT_SCHEDULER_H_
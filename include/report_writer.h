@@ -0,0 +1,96 @@
+#ifndef REPORT_WRITER_H_
+#define REPORT_WRITER_H_
+#include <Arduino.h>
+
+// Flat JSON object writer over a caller owned buffer. No heap, no printf.
+// Values are written as is, keys and string values must not need escaping.
+// If the buffer runs out the writer stops and sets bOverflow, the output is still terminated.
+
+typedef struct {
+    char * pcBuf;
+    size_t uiSize;
+    size_t uiLen;
+    bool bOverflow;
+    bool bFirst;
+} report_writer_t;
+
+void vReportPutRaw(report_writer_t * pxW, const char * pc, size_t len) {
+    if (pxW->bOverflow) return;
+    if (pxW->uiLen + len + 2 > pxW->uiSize) {   // always keep room for '}' and '\0'
+        pxW->bOverflow = true;
+        return;
+    }
+    memcpy(pxW->pcBuf + pxW->uiLen, pc, len);
+    pxW->uiLen += len;
+}
+
+void vReportPutChar(report_writer_t * pxW, char c) {
+    vReportPutRaw(pxW, &c, 1);
+}
+
+void vReportPutUInt(report_writer_t * pxW, uint64_t ullValue) {
+    char pcDigits[20];
+    uint8_t i = sizeof(pcDigits);
+    do {
+        pcDigits[--i] = '0' + (ullValue % 10);
+        ullValue /= 10;
+    } while (ullValue && i);
+    vReportPutRaw(pxW, pcDigits + i, sizeof(pcDigits) - i);
+}
+
+void vReportPutInt(report_writer_t * pxW, int64_t llValue) {
+    if (llValue < 0) {
+        vReportPutChar(pxW, '-');
+        vReportPutUInt(pxW, (uint64_t)0 - (uint64_t)llValue);
+    } else {
+        vReportPutUInt(pxW, (uint64_t)llValue);
+    }
+}
+
+void vReportPutKey(report_writer_t * pxW, const char * pcKey) {
+    if (!pxW->bFirst) vReportPutChar(pxW, ',');
+    pxW->bFirst = false;
+    vReportPutChar(pxW, '"');
+    vReportPutRaw(pxW, pcKey, strlen(pcKey));
+    vReportPutRaw(pxW, "\":", 2);
+}
+
+void vReportBegin(report_writer_t * pxW, char * pcBuf, size_t uiSize) {
+    pxW->pcBuf = pcBuf;
+    pxW->uiSize = uiSize;
+    pxW->uiLen = 0;
+    pxW->bOverflow = false;
+    pxW->bFirst = true;
+    vReportPutChar(pxW, '{');
+}
+
+void vReportAddStr(report_writer_t * pxW, const char * pcKey, const char * pcValue) {
+    vReportPutKey(pxW, pcKey);
+    vReportPutChar(pxW, '"');
+    vReportPutRaw(pxW, pcValue, strlen(pcValue));
+    vReportPutChar(pxW, '"');
+}
+
+void vReportAddInt(report_writer_t * pxW, const char * pcKey, int64_t llValue) {
+    vReportPutKey(pxW, pcKey);
+    vReportPutInt(pxW, llValue);
+}
+
+void vReportAddIp(report_writer_t * pxW, const char * pcKey, uint32_t ulAddr) {
+    vReportPutKey(pxW, pcKey);
+    vReportPutChar(pxW, '"');
+    for (uint8_t i = 0; i < 4; i++) {   // lwip keeps the address in network order
+        if (i) vReportPutChar(pxW, '.');
+        vReportPutUInt(pxW, (ulAddr >> (8 * i)) & 0xFF);
+    }
+    vReportPutChar(pxW, '"');
+}
+
+// Closes the object and returns the length without the terminating zero
+size_t uiReportEnd(report_writer_t * pxW) {
+    pxW->pcBuf[pxW->uiLen++] = '}';     // room is reserved by vReportPutRaw
+    pxW->pcBuf[pxW->uiLen] = '\0';
+    return pxW->uiLen;
+}
+
+#endif  // REPORT_WRITER_H_
@@ -0,0 +1,17 @@
+#ifndef RTC_LAYOUT_H_
+#define RTC_LAYOUT_H_
+
+// RTC user memory map, in 4 byte blocks (ESP.rtcUserMemoryRead/Write offsets).
+// RTC memory survives reset and deep sleep, but not a power cycle.
+// Blocks 0..31 are left to eboot, it keeps the OTA command there.
+
+#define RTC_BLOCK_SIZE          4
+#define RTC_USER_BLOCKS         128
+
+#define RTC_JOURNAL_BLOCK       32      // report_journal.h
+#define RTC_JOURNAL_BLOCKS      75
+
+#define RTC_SESSION_BLOCK       107     // net_session.h
+#define RTC_SESSION_BLOCKS      8
+
+#endif  // RTC_LAYOUT_H_
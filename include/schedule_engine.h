@@ -0,0 +1,184 @@
+#ifndef SCHEDULE_ENGINE_H_
+#define SCHEDULE_ENGINE_H_
+#include <Arduino.h>
+#include <Time.h>
+#include <crc16.h>
+
+// Local relay schedule, keeps working through broker outages once the clock is set (ping or NTP).
+// Entries are kept sorted by time of day. tScheduleNext() computes the one next deadline,
+// so nothing is scanned until it comes. Text form, entries separated by ';' or a new line:
+//   "18:30 12345 2 ON;07:00 * 1 OFF"
+// local time, days (1 = Monday .. 7 = Sunday, * = every day), channel from 1, ON/OFF/TOGGLE.
+// An empty payload clears the schedule. The sketch keeps the sealed table in the flash store.
+
+#ifndef NR_SCHEDULE
+#define NR_SCHEDULE true
+#endif
+#ifndef NR_MQTT_SCHEDULE_TOPIC
+#define NR_MQTT_SCHEDULE_TOPIC NR_MQTT_SET_TOPIC "/schedule"
+#endif
+
+#define SCHED_MAX_ENTRIES   32
+#define SCHED_MAGIC         0x53434844UL    // "SCHD"
+#define SCHED_EVERY_DAY     0x7F
+
+#define SCHED_CMD_ON        1       // same values as relay_command_t
+#define SCHED_CMD_OFF       2
+#define SCHED_CMD_TOGGLE    3
+
+typedef struct {
+    uint16_t uiMinute;      // minute of the day, local time
+    uint8_t uiDays;         // bit 0 = Monday .. bit 6 = Sunday
+    uint8_t uiAction;       // channel index << 2 | SCHED_CMD_*
+} sched_entry_t;
+
+// As stored
+typedef struct {
+    uint32_t ulMagic;
+    uint8_t uiCount;
+    uint8_t uiReserved;
+    uint16_t uiCrc;
+    sched_entry_t xEntries[SCHED_MAX_ENTRIES];
+} schedule_table_t;
+
+typedef struct {
+    schedule_table_t xTable;
+    time_t tNext;           // next deadline, local time, 0 = none
+    uint16_t uiNextMinute;
+    uint8_t uiNextDay;      // 0 = Monday
+    bool bDirty;            // table replaced, save it and compute tNext again
+} schedule_t;
+
+uint8_t uiSchedChannel(const sched_entry_t * pxEntry) { return pxEntry->uiAction >> 2; }
+uint8_t uiSchedCommand(const sched_entry_t * pxEntry) { return pxEntry->uiAction & 0x03; }
+
+uint16_t uiSchedCrc(const schedule_table_t * pxTable) {
+    return uiCrc16(pxTable->xEntries, pxTable->uiCount * sizeof(sched_entry_t));
+}
+
+// pxStored: the table saved before, NULL if there is none. A damaged one is dropped.
+void vScheduleBegin(schedule_t * pxSched, const schedule_table_t * pxStored) {
+    memset(pxSched, 0, sizeof(schedule_t));
+    if (!pxStored || pxStored->ulMagic != SCHED_MAGIC || pxStored->uiCount > SCHED_MAX_ENTRIES || pxStored->uiCrc != uiSchedCrc(pxStored)) return;
+    pxSched->xTable = *pxStored;
+}
+
+// Makes the table ready to be stored
+void vScheduleSeal(schedule_t * pxSched) {
+    schedule_table_t * pxTable = &pxSched->xTable;
+    pxTable->ulMagic = SCHED_MAGIC;
+    pxTable->uiCrc = uiSchedCrc(pxTable);
+}
+
+// Next word of an entry, false at its end
+bool bSchedToken(const char ** ppc, const char * pcEnd, const char ** ppcTok, uint8_t * puiLen) {
+    const char * pc = *ppc;
+    while (pc < pcEnd && (*pc == ' ' || *pc == '\t' || *pc == '\r')) pc++;
+    *ppcTok = pc;
+    while (pc < pcEnd && *pc != ' ' && *pc != '\t' && *pc != '\r') pc++;
+    *puiLen = pc - *ppcTok;
+    *ppc = pc;
+    return *puiLen > 0;
+}
+
+bool bSchedTokenEq(const char * pcTok, uint8_t uiLen, const char * pcWord) {
+    return strlen(pcWord) == uiLen && strncasecmp(pcTok, pcWord, uiLen) == 0;
+}
+
+// 1 = entry parsed, 0 = blank, -1 = error
+int8_t iSchedParseEntry(const char * pc, const char * pcEnd, uint8_t uiChannels, sched_entry_t * pxEntry) {
+    const char * pcTok;
+    uint8_t uiLen;
+    if (!bSchedToken(&pc, pcEnd, &pcTok, &uiLen)) return 0;
+    if (uiLen != 5 || pcTok[2] != ':' || !isdigit(pcTok[0]) || !isdigit(pcTok[1]) || !isdigit(pcTok[3]) || !isdigit(pcTok[4])) return -1;
+    uint8_t uiHour = (pcTok[0] - '0') * 10 + (pcTok[1] - '0');
+    uint8_t uiMinute = (pcTok[3] - '0') * 10 + (pcTok[4] - '0');
+    if (uiHour > 23 || uiMinute > 59) return -1;
+    pxEntry->uiMinute = uiHour * 60 + uiMinute;
+
+    if (!bSchedToken(&pc, pcEnd, &pcTok, &uiLen)) return -1;
+    pxEntry->uiDays = 0;
+    if (uiLen == 1 && *pcTok == '*') {
+        pxEntry->uiDays = SCHED_EVERY_DAY;
+    } else {
+        for (uint8_t i = 0; i < uiLen; i++) {
+            if (pcTok[i] < '1' || pcTok[i] > '7') return -1;
+            pxEntry->uiDays |= 1 << (pcTok[i] - '1');
+        }
+    }
+
+    if (!bSchedToken(&pc, pcEnd, &pcTok, &uiLen) || uiLen > 2) return -1;
+    uint8_t uiChannel = 0;
+    for (uint8_t i = 0; i < uiLen; i++) {
+        if (!isdigit(pcTok[i])) return -1;
+        uiChannel = uiChannel * 10 + (pcTok[i] - '0');
+    }
+    if (uiChannel < 1 || uiChannel > uiChannels) return -1;
+
+    if (!bSchedToken(&pc, pcEnd, &pcTok, &uiLen)) return -1;
+    uint8_t uiCommand;
+    if (bSchedTokenEq(pcTok, uiLen, "ON")) uiCommand = SCHED_CMD_ON;
+    else if (bSchedTokenEq(pcTok, uiLen, "OFF")) uiCommand = SCHED_CMD_OFF;
+    else if (bSchedTokenEq(pcTok, uiLen, "TOGGLE")) uiCommand = SCHED_CMD_TOGGLE;
+    else return -1;
+    pxEntry->uiAction = (uiChannel - 1) << 2 | uiCommand;
+
+    if (bSchedToken(&pc, pcEnd, &pcTok, &uiLen)) return -1;    // trailing garbage
+    return 1;
+}
+
+// Parses the whole text into pxTable, sorted by time of day. Returns the failed entry number
+// from 1, or 0 on success. Entries of the same minute keep their order.
+uint8_t uiScheduleParse(schedule_table_t * pxTable, const char * pc, size_t len, uint8_t uiChannels) {
+    const char * pcEnd = pc + len;
+    uint8_t uiEntry = 0;
+    memset(pxTable, 0, sizeof(schedule_table_t));
+    while (pc < pcEnd) {
+        const char * pcEol = pc;
+        while (pcEol < pcEnd && *pcEol != ';' && *pcEol != '\n') pcEol++;
+        uiEntry++;
+        sched_entry_t xEntry;
+        int8_t iResult = iSchedParseEntry(pc, pcEol, uiChannels, &xEntry);
+        if (iResult < 0 || (iResult > 0 && pxTable->uiCount == SCHED_MAX_ENTRIES)) return uiEntry;
+        if (iResult > 0) {
+            uint8_t i = pxTable->uiCount++;
+            while (i > 0 && pxTable->xEntries[i - 1].uiMinute > xEntry.uiMinute) {
+                pxTable->xEntries[i] = pxTable->xEntries[i - 1];
+                i--;
+            }
+            pxTable->xEntries[i] = xEntry;
+        }
+        pc = pcEol + 1;
+    }
+    return 0;
+}
+
+// Finds the first deadline after tNow (local time). The table is sorted, so the first entry
+// of the nearest day that matches is the answer. Returns 0 if the schedule is empty.
+time_t tScheduleNext(schedule_t * pxSched, time_t tNow) {
+    const schedule_table_t * pxTable = &pxSched->xTable;
+    pxSched->tNext = 0;
+    time_t tMidnight = previousMidnight(tNow);
+    uint16_t uiNowMinute = elapsedSecsToday(tNow) / SECS_PER_MIN;
+    uint8_t uiToday = (dayOfWeek(tNow) + 5) % 7;    // TimeLib: 1 = Sunday
+    for (uint8_t uiAhead = 0; uiAhead <= 7 && pxTable->uiCount > 0; uiAhead++) {
+        uint8_t uiDay = (uiToday + uiAhead) % 7;
+        for (uint8_t i = 0; i < pxTable->uiCount; i++) {
+            const sched_entry_t * pxEntry = &pxTable->xEntries[i];
+            if (uiAhead == 0 && pxEntry->uiMinute <= uiNowMinute) continue;
+            if (!(pxEntry->uiDays & (1 << uiDay))) continue;
+            pxSched->uiNextMinute = pxEntry->uiMinute;
+            pxSched->uiNextDay = uiDay;
+            pxSched->tNext = tMidnight + uiAhead * SECS_PER_DAY + pxEntry->uiMinute * SECS_PER_MIN;
+            return pxSched->tNext;
+        }
+    }
+    return 0;
+}
+
+// Does the entry belong to the deadline in tNext?
+bool bScheduleEntryDue(const schedule_t * pxSched, const sched_entry_t * pxEntry) {
+    return pxEntry->uiMinute == pxSched->uiNextMinute && (pxEntry->uiDays & (1 << pxSched->uiNextDay));
+}
+
+#endif  // SCHEDULE_ENGINE_H_
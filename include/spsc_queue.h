@@ -0,0 +1,53 @@
+#ifndef SPSC_QUEUE_H_
+#define SPSC_QUEUE_H_
+#include <Arduino.h>
+
+// Bounded lock-free single-producer/single-consumer ring.
+// The producer only writes uiHead, the consumer only writes uiTail, so no locks are needed
+// as long as pushes never preempt each other. On ESP8266 this holds for SYS callbacks (WiFi,
+// async TCP) and loop(), which only switch at yield points. Never push from an ISR.
+// SIZE must be a power of two, one slot is always kept free.
+
+template <typename T, uint8_t SIZE>
+struct spsc_queue_t {
+    T xItems[SIZE];
+    volatile uint8_t uiHead;
+    volatile uint8_t uiTail;
+    uint8_t uiDepthMax;
+    uint32_t ulDropped;
+};
+
+template <typename T, uint8_t SIZE>
+uint8_t uiQueueDepth(const spsc_queue_t<T, SIZE> * pxQueue) {
+    return (uint8_t)(pxQueue->uiHead - pxQueue->uiTail) & (SIZE - 1);
+}
+
+template <typename T, uint8_t SIZE>
+bool bQueuePush(spsc_queue_t<T, SIZE> * pxQueue, const T * pxItem) {
+    static_assert((SIZE & (SIZE - 1)) == 0, "queue size must be a power of two");
+    uint8_t uiHead = pxQueue->uiHead;
+    uint8_t uiNext = (uiHead + 1) & (SIZE - 1);
+    if (uiNext == pxQueue->uiTail) {
+        pxQueue->ulDropped++;
+        return false;
+    }
+    pxQueue->xItems[uiHead] = *pxItem;
+    __sync_synchronize();   // item must be visible before the new head
+    pxQueue->uiHead = uiNext;
+    uint8_t uiDepth = uiQueueDepth(pxQueue);
+    if (uiDepth > pxQueue->uiDepthMax) pxQueue->uiDepthMax = uiDepth;
+    return true;
+}
+
+template <typename T, uint8_t SIZE>
+bool bQueuePop(spsc_queue_t<T, SIZE> * pxQueue, T * pxItem) {
+    uint8_t uiTail = pxQueue->uiTail;
+    if (uiTail == pxQueue->uiHead) return false;
+    __sync_synchronize();   // read the item only after seeing the head
+    *pxItem = pxQueue->xItems[uiTail];
+    __sync_synchronize();   // slot is free only after the item is copied out
+    pxQueue->uiTail = (uiTail + 1) & (SIZE - 1);
+    return true;
+}
+
+#endif  // SPSC_QUEUE_H_
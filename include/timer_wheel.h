@@ -0,0 +1,162 @@
+#ifndef TIMER_WHEEL_H_
+#define TIMER_WHEEL_H_
+#include <Arduino.h>
+
+// One hierarchical timer wheel for every deadline of the firmware, driven from loop().
+// TW_LEVELS levels of TW_SLOTS slots, level 0 slot is TW_TICK_MS, every next level's slot
+// spans the whole previous level. A timer sits in the slot of its expiry at the lowest level
+// that can hold it and moves down when that slot comes up. Arm and cancel are O(1) list
+// operations on the wheel_timer_t embedded in its owner, nothing is allocated.
+// Callbacks run in loop() (CONT), never in the SYS timer context. Arming and cancelling from
+// SYS callbacks (WiFi, async TCP) is fine, they only switch with loop() at yield points.
+// Longer delays than the wheel holds (TW_TICK_MS * TW_SLOTS^TW_LEVELS) just take several turns
+// of the top level.
+
+#ifndef TW_TICK_MS
+#define TW_TICK_MS      10
+#endif
+#define TW_SLOT_BITS    5
+#define TW_SLOTS        (1 << TW_SLOT_BITS)
+#define TW_SLOT_MASK    (TW_SLOTS - 1)
+#define TW_LEVELS       4       // 10 ms * 32^4, about 2.9 hours without extra turns
+
+typedef void (*vTimerCB_t)(uint32_t ulArg);
+
+typedef struct wheel_timer_s {
+    struct wheel_timer_s * pxNext;
+    struct wheel_timer_s ** ppxPrev;    // link pointing at this timer, NULL when not armed
+    uint32_t ulExpires;                 // in ticks
+    uint32_t ulPeriod;                  // in ticks, 0 = one shot
+    vTimerCB_t pvCB;
+    uint32_t ulArg;
+} wheel_timer_t;
+
+typedef struct {
+    wheel_timer_t * pxSlots[TW_LEVELS][TW_SLOTS];
+    uint32_t ulTicks;       // every timer up to this tick has run
+    uint32_t ulLastMs;      // millis() of ulTicks
+    uint32_t ulFired;
+    uint32_t ulLagMaxMs;    // longest a tick waited for loop()
+} timer_wheel_t;
+
+void vTimerWheelBegin(timer_wheel_t * pxWheel) {
+    memset(pxWheel, 0, sizeof(timer_wheel_t));
+    pxWheel->ulLastMs = millis();
+}
+
+bool bTimerArmed(const wheel_timer_t * pxTimer) {
+    return pxTimer->ppxPrev != NULL;
+}
+
+void vTimerCancel(wheel_timer_t * pxTimer) {
+    if (!pxTimer->ppxPrev) return;
+    *pxTimer->ppxPrev = pxTimer->pxNext;
+    if (pxTimer->pxNext) pxTimer->pxNext->ppxPrev = pxTimer->ppxPrev;
+    pxTimer->pxNext = NULL;
+    pxTimer->ppxPrev = NULL;
+}
+
+void vTimerLink(wheel_timer_t ** ppxHead, wheel_timer_t * pxTimer) {
+    pxTimer->pxNext = *ppxHead;
+    if (*ppxHead) (*ppxHead)->ppxPrev = &pxTimer->pxNext;
+    pxTimer->ppxPrev = ppxHead;
+    *ppxHead = pxTimer;
+}
+
+void vTimerPlace(timer_wheel_t * pxWheel, wheel_timer_t * pxTimer) {
+    uint32_t ulDelta = pxTimer->ulExpires - pxWheel->ulTicks;
+    for (uint8_t uiLevel = 0; uiLevel < TW_LEVELS; uiLevel++) {
+        uint8_t uiShift = uiLevel * TW_SLOT_BITS;
+        if (uiLevel == TW_LEVELS - 1 || ulDelta < (1UL << (uiShift + TW_SLOT_BITS))) {
+            uint32_t ulAt = pxTimer->ulExpires;
+            // too far for the wheel: park it in the last slot of the top level, it comes back from there
+            if (uiLevel == TW_LEVELS - 1 && ulDelta >= (1UL << (uiShift + TW_SLOT_BITS))) {
+                ulAt = pxWheel->ulTicks + (TW_SLOT_MASK << uiShift);
+            }
+            vTimerLink(&pxWheel->pxSlots[uiLevel][(ulAt >> uiShift) & TW_SLOT_MASK], pxTimer);
+            return;
+        }
+    }
+}
+
+// (Re)arms the timer, ulPeriodMs > 0 makes it fire again every ulPeriodMs
+void vTimerArm(timer_wheel_t * pxWheel, wheel_timer_t * pxTimer, uint32_t ulDelayMs, vTimerCB_t pvCB, uint32_t ulArg = 0, uint32_t ulPeriodMs = 0) {
+    vTimerCancel(pxTimer);
+    uint32_t ulTicks = (ulDelayMs + (millis() - pxWheel->ulLastMs) + TW_TICK_MS - 1) / TW_TICK_MS;
+    pxTimer->ulExpires = pxWheel->ulTicks + (ulTicks ? ulTicks : 1);
+    pxTimer->ulPeriod = (ulPeriodMs + TW_TICK_MS - 1) / TW_TICK_MS;
+    pxTimer->pvCB = pvCB;
+    pxTimer->ulArg = ulArg;
+    vTimerPlace(pxWheel, pxTimer);
+}
+
+// Moves the timers of one upper level slot down, each to where it belongs now
+void vTimerCascade(timer_wheel_t * pxWheel, uint8_t uiLevel) {
+    wheel_timer_t ** ppxSlot = &pxWheel->pxSlots[uiLevel][(pxWheel->ulTicks >> (uiLevel * TW_SLOT_BITS)) & TW_SLOT_MASK];
+    wheel_timer_t * pxList = *ppxSlot;
+    *ppxSlot = NULL;
+    while (pxList) {
+        wheel_timer_t * pxTimer = pxList;
+        pxList = pxTimer->pxNext;
+        vTimerPlace(pxWheel, pxTimer);
+    }
+}
+
+// Called from loop(): advances the wheel to millis() and runs whatever expired
+void vTimerWheelRun(timer_wheel_t * pxWheel) {
+    uint32_t ulElapsed = millis() - pxWheel->ulLastMs;
+    if (ulElapsed < TW_TICK_MS) return;
+    if (ulElapsed - TW_TICK_MS > pxWheel->ulLagMaxMs) pxWheel->ulLagMaxMs = ulElapsed - TW_TICK_MS;
+    for (; ulElapsed >= TW_TICK_MS; ulElapsed -= TW_TICK_MS) {
+        pxWheel->ulTicks++;
+        pxWheel->ulLastMs += TW_TICK_MS;
+        for (uint8_t uiLevel = 1; uiLevel < TW_LEVELS; uiLevel++) {
+            if ((pxWheel->ulTicks >> ((uiLevel - 1) * TW_SLOT_BITS)) & TW_SLOT_MASK) break;
+            vTimerCascade(pxWheel, uiLevel);
+        }
+        // Take the whole slot first, so callbacks may arm and cancel anything, this slot included
+        wheel_timer_t * pxDue = NULL;
+        wheel_timer_t ** ppxSlot = &pxWheel->pxSlots[0][pxWheel->ulTicks & TW_SLOT_MASK];
+        if (*ppxSlot) {
+            pxDue = *ppxSlot;
+            pxDue->ppxPrev = &pxDue;
+            *ppxSlot = NULL;
+        }
+        while (pxDue) {
+            wheel_timer_t * pxTimer = pxDue;
+            vTimerCancel(pxTimer);
+            if (pxTimer->ulPeriod) {
+                pxTimer->ulExpires += pxTimer->ulPeriod;
+                vTimerPlace(pxWheel, pxTimer);
+            }
+            pxWheel->ulFired++;
+            pxTimer->pvCB(pxTimer->ulArg);
+        }
+    }
+}
+
+// Milliseconds until vTimerWheelRun() has something to do, at most ulLimitMs. An upper level slot
+// counts from when it cascades, so this may wake early, never late. For sleeping up to a deadline.
+uint32_t ulTimerWheelNextMs(const timer_wheel_t * pxWheel, uint32_t ulLimitMs) {
+    uint32_t ulTicks = ulLimitMs / TW_TICK_MS + 1;
+    for (uint8_t uiLevel = 0; uiLevel < TW_LEVELS; uiLevel++) {
+        uint8_t uiShift = uiLevel * TW_SLOT_BITS;
+        uint32_t ulSlot = pxWheel->ulTicks >> uiShift;
+        for (uint32_t j = 1; j <= TW_SLOTS; j++) {
+            uint32_t ulAt = ((ulSlot + j) << uiShift) - pxWheel->ulTicks;     // ticks until this slot comes up
+            if (ulAt >= ulTicks) break;
+            if (pxWheel->pxSlots[uiLevel][(ulSlot + j) & TW_SLOT_MASK]) {
+                ulTicks = ulAt;
+                break;
+            }
+        }
+    }
+    uint32_t ulSince = millis() - pxWheel->ulLastMs;
+    uint32_t ulMs = ulTicks * TW_TICK_MS;
+    ulMs = ulMs > ulSince ? ulMs - ulSince : 0;
+    return min(ulMs, ulLimitMs);
+}
+
+timer_wheel_t xTimerWheel;      // the one every module uses
+
+#endif  // TIMER_WHEEL_H_
@@ -0,0 +1,68 @@
+#ifndef TOPIC_ROUTER_H_
+#define TOPIC_ROUTER_H_
+#include <Arduino.h>
+
+// Incoming topic dispatch. Routes are a constexpr table, their FNV-1a hashes are computed
+// by the compiler (TOPIC_ROUTE). vRouterBegin() puts them into a small open addressing index,
+// so dispatch is one hash of the incoming topic, one probe in the common case and one strcmp.
+
+#ifndef ROUTER_BUCKETS
+#define ROUTER_BUCKETS  32      // power of two, at least twice the routes count: 10 with every option on
+#endif
+
+typedef void (*vTopicCB_t)(char* pcTopic, char* pcPayload, size_t len);
+// Incremental consumers get every chunk as it comes, see mqtt_reassembly.h
+typedef void (*vTopicChunkCB_t)(char* pcTopic, const char* pcChunk, size_t len, size_t index, size_t total);
+
+typedef struct {
+    uint32_t ulHash;
+    const char * pcTopic;
+    vTopicCB_t pvCB;                // whole message, NUL terminated
+    vTopicChunkCB_t pvChunkCB;      // or the chunks, straight from the client
+} topic_route_t;
+
+typedef struct {
+    const topic_route_t * pxRoutes;
+    uint8_t uiCount;
+    uint8_t uiIndex[ROUTER_BUCKETS];    // route number + 1, 0 = empty
+} topic_router_t;
+
+constexpr uint32_t ulTopicHash(const char * pc, uint32_t ulHash = 2166136261UL) {
+    return *pc ? ulTopicHash(pc + 1, (ulHash ^ (uint8_t)*pc) * 16777619UL) : ulHash;
+}
+
+#define TOPIC_ROUTE(topic, cb)          { ulTopicHash(topic), topic, cb, NULL }
+#define TOPIC_ROUTE_STREAM(topic, cb)   { ulTopicHash(topic), topic, NULL, cb }
+
+uint32_t ulTopicHashRuntime(const char * pc) {
+    uint32_t ulHash = 2166136261UL;
+    while (*pc) ulHash = (ulHash ^ (uint8_t)*pc++) * 16777619UL;
+    return ulHash;
+}
+
+bool bRouterBegin(topic_router_t * pxRouter, const topic_route_t * pxRoutes, uint8_t uiCount) {
+    pxRouter->pxRoutes = pxRoutes;
+    pxRouter->uiCount = 0;
+    memset(pxRouter->uiIndex, 0, sizeof(pxRouter->uiIndex));
+    if (uiCount >= ROUTER_BUCKETS) return false;
+    for (uint8_t i = 0; i < uiCount; i++) {
+        uint8_t uiBucket = pxRoutes[i].ulHash & (ROUTER_BUCKETS - 1);
+        while (pxRouter->uiIndex[uiBucket]) uiBucket = (uiBucket + 1) & (ROUTER_BUCKETS - 1);
+        pxRouter->uiIndex[uiBucket] = i + 1;
+    }
+    pxRouter->uiCount = uiCount;
+    return true;
+}
+
+const topic_route_t * pxRouterFind(const topic_router_t * pxRouter, const char * pcTopic) {
+    uint32_t ulHash = ulTopicHashRuntime(pcTopic);
+    uint8_t uiBucket = ulHash & (ROUTER_BUCKETS - 1);
+    while (pxRouter->uiIndex[uiBucket]) {
+        const topic_route_t * pxRoute = &pxRouter->pxRoutes[pxRouter->uiIndex[uiBucket] - 1];
+        if (pxRoute->ulHash == ulHash && strcmp(pxRoute->pcTopic, pcTopic) == 0) return pxRoute;
+        uiBucket = (uiBucket + 1) & (ROUTER_BUCKETS - 1);
+    }
+    return NULL;
+}
+
+#endif  // TOPIC_ROUTER_H_
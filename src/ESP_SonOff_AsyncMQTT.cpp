@@ -1,12 +1,30 @@
 
 #include <Arduino.h>
 #include <ArduinoOTA.h>
-#include <Arduino_JSON.h>
-#include <Ticker.h>
 #include <Time.h>
 
 #include <env_options.h>
 
+#include <bench_routine.h>
+#include <binary_protocol.h>
+#include <button_routine.h>
+#include <channel_table.h>
+#include <flash_store.h>
+#include <group_control.h>
+#include <json_parser.h>
+#include <lan_control.h>
+#include <latency_stats.h>
+#include <log_routine.h>
+#include <ota_routine.h>
+#include <power_policy.h>
+#include <profiler.h>
+#include <report_journal.h>
+#include <report_writer.h>
+#include <report_scheduler.h>
+#include <schedule_engine.h>
+#include <spsc_queue.h>
+#include <timer_wheel.h>
+#include <topic_router.h>
 #include <net_routine.h>
 
 // ----------- Пины esp8285 -----------------
@@ -27,46 +45,57 @@
 // #define PIN_RELAY3      16
 // #define PIN_WIFI_LED    LED_BUILTIN
 
+// ----------- Каналы: номер, реле, кнопка -----------------
+#define CHANNELS(X) \
+    X(1, PIN_RELAY1, PIN_BTN1) \
+    X(2, PIN_RELAY2, PIN_BTN2) \
+    X(3, PIN_RELAY3, PIN_BTN3)
+
+constexpr channel_t xChannels[CHANNELS_COUNT] = { CHANNELS(CHANNEL_ENTRY) };
+static_assert(CHANNELS_COUNT <= CHANNELS_MAX, "too many channels");
+
 #define LED_STATE_ON            LOW
 #define LED_STATE_OFF           HIGH
 
-#define BUTTONS_COUNT   3
-#define BUTTON_STATE_PUSH       LOW
-#define BUTTON_STATE_RELEASE    HIGH
+#define BUTTONS_COUNT   CHANNELS_COUNT
 
-#define RELAYS_COUNT   3
+#define RELAYS_COUNT    CHANNELS_COUNT
 #define RELAY_STATE_ON  HIGH
 #define RELAY_STATE_OFF LOW
 
 #define AUTOOFF_DELAY_SECS  3600
 
+#ifndef NR_MQTT_CHANNEL_TOPICS
+#define NR_MQTT_CHANNEL_TOPICS  true
+#endif
+
 
 #define SR_WAITING      BIT0
-#define SR_PONG         BIT1
-#define SR_RELAY1       BIT2
-#define SR_RELAY2       BIT3
-#define SR_RELAY3       BIT4
-#define SR_RELAYS       SR_RELAY1 | SR_RELAY2 | SR_RELAY3       
-#define SR_EXIT_CODE    BIT5
-#define SR_DEVINFO      BIT6
+#define SR_PONG         BIT1    // only if the immediate pong could not be sent
+#define SR_RELAYS       BIT2
+#define SR_EXIT_CODE    BIT3
+#define SR_DEVINFO      BIT4
+#define SR_FULL         BIT5    // report the relays even if the backend already has their state
 
 uint8_t uiReportBits = 0;
 uint8_t uiExitCode = 0;
+report_scheduler_t xReportSched;
+journal_t xJournal;
+char pcJournalBuf[JOURNAL_REPORT_LEN];
+bool bJournalReplayPending = false;
 
-typedef struct {
-    uint8_t uiPin;
-    uint8_t uiRead;
-    uint8_t uiState;
-    bool bChanged;
-    uint32_t ulChangedAt;
-    uint32_t ulPrevStateDuration;
-} button_t;
+// Longest possible report, every SR_* bit set
+#define REPORT_MAX_LEN  (sizeof("{\"pong\":-9223372036854775808,") - 1 + CHANNELS_COUNT * (sizeof("\"l16_state\":\"OFF\",") - 1) + \
+                         sizeof("\"exit_code\":255,\"device_id\":\"" NR_DEVICE_ID "\",\"device_alias\":\"" NR_DEVICE_ALIAS "\"," \
+                               "\"ip_address\":\"255.255.255.255\",\"cmd_queue\":255,\"cmd_queue_max\":255," \
+                               "\"cmd_dropped\":4294967295,\"cmd_latency_us\":4294967295,\"cmd_latency_max_us\":4294967295," \
+                               "\"boot_mqtt_ms\":4294967295,\"boot_report_ms\":4294967295,\"boot_fast\":1,\"flash_store\":1}"))
+char pcReportBuf[REPORT_MAX_LEN];
+uint32_t ulBootReportMs = 0;    // power-on to the first state report
+bool bBootFast = false;         // boot found a cached AP and lease
 
-button_t xButtons[BUTTONS_COUNT] = {
-    { PIN_BTN1, BUTTON_STATE_RELEASE, BUTTON_STATE_RELEASE, false, 0, 0 },
-    { PIN_BTN2, BUTTON_STATE_RELEASE, BUTTON_STATE_RELEASE, false, 0, 0 },
-    { PIN_BTN3, BUTTON_STATE_RELEASE, BUTTON_STATE_RELEASE, false, 0, 0 },
-};
+#define CHANNEL_BUTTON(n, relay, button)    { button, BUTTON_STATE_RELEASE },
+button_t xButtons[BUTTONS_COUNT] = { CHANNELS(CHANNEL_BUTTON) };
 
 
 typedef enum {
@@ -76,50 +105,118 @@ typedef enum {
     RELAY_CMD_TOGGLE
 } relay_command_t;
 
+// Pins are in xChannels
 typedef struct {
-    uint8_t uiPin;
     uint8_t uiState;
-    relay_command_t xScheduledCommand;
-    bool bScheduledCommandChanged;
-    uint8_t uiReportBit;
     uint32_t ulChangedAt;
     uint16_t uiAutoOffAfterSecs;
-    Ticker xAutoOffTimer;
+    wheel_timer_t xAutoOffTimer;
 } relay_t;
 
-relay_t xRelays[RELAYS_COUNT] = {
-    { PIN_RELAY1, RELAY_STATE_OFF, RELAY_CMD_NONE, false, SR_RELAY1, 0, AUTOOFF_DELAY_SECS },
-    { PIN_RELAY2, RELAY_STATE_OFF, RELAY_CMD_NONE, false, SR_RELAY2, 0, AUTOOFF_DELAY_SECS },
-    { PIN_RELAY3, RELAY_STATE_OFF, RELAY_CMD_NONE, false, SR_RELAY3, 0, AUTOOFF_DELAY_SECS },
-};
+#define CHANNEL_RELAY(n, relay, button)     { RELAY_STATE_OFF, 0, AUTOOFF_DELAY_SECS },
+relay_t xRelays[RELAYS_COUNT] = { CHANNELS(CHANNEL_RELAY) };
+
+// Survives a power cycle, see flash_store.h
+typedef enum {
+    FS_KEY_RELAYS = 0,      // uint16_t, bit N = relay N+1 is ON
+    FS_KEY_AUTOOFF,         // uint16_t[RELAYS_COUNT], uiAutoOffAfterSecs
+    FS_KEY_SCHEDULE         // schedule_table_t
+} flash_store_key_t;
+static_assert(sizeof(schedule_table_t) <= FLASH_STORE_VALUE_MAX, "schedule does not fit into a flash store value");
+
+flash_store_t xFlashStore;
+
+// Commands from MQTT (SYS context) and from buttons and timers (loop())
+// are queued here and executed in order from loop()
+#define RELAY_QUEUE_SIZE    16
+
+typedef enum {
+    CMD_SRC_LOCAL = 0,      // buttons, timers
+    CMD_SRC_MQTT,
+    CMD_SRC_MQTT_BINARY,
+    CMD_SRC_LAN
+} command_source_t;
+
+typedef struct {
+    relay_command_t xCommands[RELAYS_COUNT];
+    command_source_t xSource;
+    uint16_t uiSeq;
+    uint32_t ulEnqueuedAt;
+#if NR_POWER_POLICY
+    uint32_t ulEventAt;         // ms, button edge or arrival; 0: at enqueue
+    power_state_t xPowerState;  // the state the event found
+#endif
+} relay_command_set_t;
+
+spsc_queue_t<relay_command_set_t, RELAY_QUEUE_SIZE> xRelayQueue;
+uint32_t ulActuateLatencyUs = 0;
+uint32_t ulActuateLatencyMaxUs = 0;
+#if NR_POWER_POLICY
+power_policy_t xPower;
+#endif
+
+bool bRelayEnqueue(relay_command_set_t * pxSet) {
+    pxSet->ulEnqueuedAt = micros();
+#if NR_POWER_POLICY
+    if (pxSet->ulEventAt == 0) pxSet->ulEventAt = millis();
+    pxSet->xPowerState = xPowerStateAt(&xPower, pxSet->ulEventAt);
+    vPowerWake(&xPower);
+#endif
+    if (bQueuePush(&xRelayQueue, pxSet)) return true;
+    LOG_ERROR("[ bRelayEnqueue ] Command queue is full, command dropped!");
+    return false;
+}
+
+bool bRelayEnqueueOne(uint8_t uiRelayIdx, relay_command_t xCommand) {
+    relay_command_set_t xSet;
+    memset(&xSet, 0, sizeof(xSet));
+    xSet.xCommands[uiRelayIdx] = xCommand;
+    return bRelayEnqueue(&xSet);
+}
+
+typedef enum {
+    BTN_ACTION_NONE = 0,
+    BTN_ACTION_RELAY,
+    BTN_ACTION_MQTT
+} button_action_type_t;
+
+typedef struct {
+    button_action_type_t xType;
+    uint8_t uiRelayIdx;
+    relay_command_t xCommand;
+} button_action_t;
+
+// What every gesture does: { none, single, double, long, hold }
+// Mapping a double click makes the single click wait BUTTON_DOUBLE_CLICK_MS for the second one.
+// By default every button toggles its own relay and reports a long press
+#define CHANNEL_BUTTON_ACTIONS(n, relay, button) \
+    { {}, { BTN_ACTION_RELAY, n - 1, RELAY_CMD_TOGGLE }, {}, { BTN_ACTION_MQTT }, {} },
+button_action_t xButtonActions[BUTTONS_COUNT][BTN_GESTURES_COUNT] = { CHANNELS(CHANNEL_BUTTON_ACTIONS) };
 
 char pcPingPayload[20] = "0";
 int64_t iPingPayload = 0;
 
-Ticker xReadButtonsTimer;
-Ticker xRelayCommandTimer;
-Ticker xReportTimer;
 
 
 uint32_t uiLastPingReceived = 0;
 bool bExternalControlEnabled = false;
-Ticker xNoPingWatchTimer;
+wheel_timer_t xNoPingWatchTimer;
 
-Ticker xBlinkTimer;
+wheel_timer_t xBlinkTimer;
 uint8_t uiBlinks;
 uint8_t uiLedState = LED_STATE_OFF;
 
-void vBlinkHandler() {
+void vBlinkHandler(uint32_t ulArg) {
     if (uiLedState == LED_STATE_OFF) {
         if (uiBlinks == 0) return;
         uiLedState = LED_STATE_ON;
         digitalWrite(PIN_WIFI_LED, uiLedState);
-        xBlinkTimer.once_ms(200, vBlinkHandler);
+        vTimerArm(&xTimerWheel, &xBlinkTimer, 200, vBlinkHandler);
     } else {
         uiBlinks--;
         uiLedState = LED_STATE_OFF;
         digitalWrite(PIN_WIFI_LED, uiLedState);
-        if (uiBlinks > 0) xBlinkTimer.once_ms(300, vBlinkHandler);
+        if (uiBlinks > 0) vTimerArm(&xTimerWheel, &xBlinkTimer, 300, vBlinkHandler);
     }
 }
 
@@ -127,102 +224,515 @@ void vBlink(uint8_t uiCount) {
     if (uiCount == 0) return;
     uiBlinks = uiCount;
     uiLedState = LED_STATE_OFF;
-    vBlinkHandler();
+    vBlinkHandler(0);
 }
 
 
-void vNoPingWatchHandler() {
+void vNoPingWatchHandler(uint32_t ulArg) {
     if (bExternalControlEnabled) return;
     uint16_t uiDiff = (millis() - uiLastPingReceived) / 1000;
     if (uiDiff > WAIT_FOR_PING_SECS) {
         bExternalControlEnabled = false;
-        Serial.printf("[ vNoPingWatchHandler ] Ping Watch timer interrupt. No pings were received in %d secs\n", uiDiff);
+        LOG_WARN("[ vNoPingWatchHandler ] Ping Watch timer interrupt. No pings were received in %d secs", uiDiff);
     }
 }
 
 void vPingCB(char* pcTopic, char* pcPayload, size_t len) {
+    PROFILE_SCOPE(PROF_PING_CB);
     bExternalControlEnabled = true;
     vBlink(1);
     uiLastPingReceived = millis();
-    Serial.printf("[ vPingCB ] MQTT Ping received. Payload: %s\n", pcPayload);
-    strcpy(pcPingPayload, pcPayload);
+    strlcpy(pcPingPayload, pcPayload, sizeof(pcPingPayload));
     iPingPayload = atoll(pcPingPayload);
+    // Pong right away, with when the ping came in and when the pong left,
+    // so the backend can tell the network from the time spent here
+    char pcPong[80];
+    report_writer_t xPong;
+    vReportBegin(&xPong, pcPong, sizeof(pcPong));
+    vReportAddInt(&xPong, "pong", iPingPayload);
+    vReportAddInt(&xPong, "rx_ms", uiLastPingReceived);
+    vReportAddInt(&xPong, "tx_ms", millis());
+    bool bPongSent = vPublishLight(mqttReportTopic, pcPong, uiReportEnd(&xPong)) != 0;
+    LOG_DEBUG("[ vPingCB ] MQTT Ping received. Payload: %s", pcPayload);
+#if NR_SYNC_TIME_MQTT
     if (timeStatus() == timeNotSet && iPingPayload != 0) {
         time_t xTime = iPingPayload / 1000 + SECS_PER_HOUR * TIME_ZONE;
         setTime(xTime);
-        Serial.printf("[ vPingCB ] Time is set to %02d.%02d.%04d %02d:%02d:%02d\n", day(), month(), year(), hour(), minute(), second());
+        LOG_INFO("[ vPingCB ] Time is set to %02d.%02d.%04d %02d:%02d:%02d", day(), month(), year(), hour(), minute(), second());
     }
-    uiReportBits |= SR_WAITING | SR_PONG | SR_RELAYS;
+#endif
+    uiReportBits |= SR_WAITING | SR_RELAYS | (bPongSent ? 0 : SR_PONG);
+}
+
+#if NR_SYNC_TIME_NTP
+// TimeLib sync provider, SNTP runs in the SDK. 0 until the first answer came.
+time_t tNtpTime() {
+    time_t tUtc = time(nullptr);
+    if (tUtc < 1600000000) return 0;
+    return tUtc + SECS_PER_HOUR * TIME_ZONE;
 }
+#endif
 
-relay_command_t xParseRelayCommand(char * pcState) {
-    if ((strcmp(pcState, "ON") == 0) || (strcmp(pcState, "on") == 0)) {
+relay_command_t xParseRelayCommand(const json_token_t * pxState) {
+    if (bJsonTokenEq(pxState, "ON") || bJsonTokenEq(pxState, "on")) {
         return RELAY_CMD_ON;
     } 
-    else if ((strcmp(pcState, "OFF") == 0) || (strcmp(pcState, "off") == 0)) {
+    else if (bJsonTokenEq(pxState, "OFF") || bJsonTokenEq(pxState, "off")) {
         return RELAY_CMD_OFF;
     }
-    else if ((strcmp(pcState, "TOGGLE") == 0) || (strcmp(pcState, "toggle") == 0)) {
+    else if (bJsonTokenEq(pxState, "TOGGLE") || bJsonTokenEq(pxState, "toggle")) {
         return RELAY_CMD_TOGGLE;
     } else {
-        Serial.printf("[ xParseRelayCommand ] Unsupported state %s\n", pcState);
+        LOG_WARN("[ xParseRelayCommand ] Unsupported state %.*s", pxState->uiLen, pxState->pc);
         return RELAY_CMD_NONE;
     }
 }
 
+typedef enum {
+    MSG_CMD_NONE = 0,
+    MSG_CMD_STATUS,
+    MSG_CMD_STATS,
+    MSG_CMD_LATENCY,
+    MSG_CMD_POWER
+} message_command_code_t;
+
+typedef struct {
+    relay_command_set_t xRelaySet;
+    message_command_code_t xCommand;
+    uint16_t uiAutoOffMask;
+    uint16_t uiAutoOffSecs[RELAYS_COUNT];
+} message_command_t;
+
+// Pulls the known keys out of the payload in one pass. Unknown keys are skipped,
+// an unsupported relay state or auto-off value rejects the whole command, so it never half-applies.
+bool bParseMessageCommand(const char * pcPayload, size_t len, message_command_t * pxCmd) {
+    memset(pxCmd, 0, sizeof(message_command_t));
+    json_cursor_t xCur;
+    json_token_t xKey, xValue;
+    if (!bJsonBegin(&xCur, pcPayload, len)) return false;
+    while (bJsonNextMember(&xCur, &xKey, &xValue)) {
+        if (xValue.xType == JSON_TYPE_NUMBER) {
+            for (int i = 0; i < RELAYS_COUNT; i++) {
+                if (!bJsonTokenEq(&xKey, xChannels[i].pcAutoOffKey)) continue;
+                uint32_t ulSecs;
+                if (!bJsonTokenToUInt(&xValue, 65535, &ulSecs)) {
+                    LOG_WARN("[ bParseMessageCommand ] Bad auto-off %.*s", xValue.uiLen, xValue.pc);
+                    return false;
+                }
+                pxCmd->uiAutoOffSecs[i] = ulSecs;
+                pxCmd->uiAutoOffMask |= 1 << i;
+                break;
+            }
+            continue;
+        }
+        if (xValue.xType != JSON_TYPE_STRING) continue;
+        if (bJsonTokenEq(&xKey, "command")) {
+            if (bJsonTokenEq(&xValue, "STATUS") || bJsonTokenEq(&xValue, "status")) {
+                pxCmd->xCommand = MSG_CMD_STATUS;
+            }
+#if NR_PROFILER
+            else if (bJsonTokenEq(&xValue, "STATS") || bJsonTokenEq(&xValue, "stats")) {
+                pxCmd->xCommand = MSG_CMD_STATS;
+            }
+#endif
+#if NR_LATENCY_STATS
+            else if (bJsonTokenEq(&xValue, "LATENCY") || bJsonTokenEq(&xValue, "latency")) {
+                pxCmd->xCommand = MSG_CMD_LATENCY;
+            }
+#endif
+#if NR_POWER_POLICY
+            else if (bJsonTokenEq(&xValue, "POWER") || bJsonTokenEq(&xValue, "power")) {
+                pxCmd->xCommand = MSG_CMD_POWER;
+            }
+#endif
+            continue;
+        }
+        for (int i = 0; i < RELAYS_COUNT; i++) {
+            if (bJsonTokenEq(&xKey, xChannels[i].pcStateKey)) {
+                pxCmd->xRelaySet.xCommands[i] = xParseRelayCommand(&xValue);
+                if (pxCmd->xRelaySet.xCommands[i] == RELAY_CMD_NONE) return false;
+                break;
+            }
+        }
+    }
+    return !xCur.bError;
+}
+
+#if NR_PROFILER
+#define STATS_NONE  0xFF
+uint8_t uiStatsNext = STATS_NONE;   // next STATS report to send: profiler slots, then heap
+#endif
+
+#if NR_POWER_POLICY
+bool bPowerReportPending = false;   // "POWER" command
+#endif
+
+#if NR_LATENCY_STATS
+#define LATENCY_NONE    0xFF
+uint8_t uiLatencyNext = LATENCY_NONE;   // next LATENCY report to send
+#endif
+
 void vMessageCB(char* pcTopic, char* pcPayload, size_t len) {
-    Serial.printf("[ vMessageCB ] Event arrived!\n");
+    PROFILE_SCOPE(PROF_MESSAGE_CB);
+    LOG_DEBUG("[ vMessageCB ] Event arrived!");
+    vBenchOnMessage();
     vBlink(1);
-    JSONVar pxPayload = JSON.parse(pcPayload);
+    message_command_t xCmd;
 
-    if (JSON.typeof(pxPayload) != "undefined") {
-        Serial.print("[ vMessageCB ] MQTT payload successfully parsed as JSON: ");
-        Serial.println(JSON.stringify(pxPayload));
+    if (bParseMessageCommand(pcPayload, len, &xCmd)) {
+        LOG_DEBUG("[ vMessageCB ] MQTT payload successfully parsed as JSON: %.*s", (int)len, pcPayload);
     } else {
-        Serial.println("[ vMessageCB ] FAIL Can't parse MQTT payload. Nothing to do :(");
+        LOG_WARN("[ vMessageCB ] FAIL Can't parse MQTT payload. Nothing to do :(");
         return;
     }
-    
-    char pcState[20];
 
-    if (pxPayload.hasOwnProperty("l1_state")) {
-        strcpy(pcState, (const char*) pxPayload["l1_state"]);
-        xRelays[0].xScheduledCommand = xParseRelayCommand(pcState);
-        xRelays[0].bScheduledCommandChanged = (xRelays[0].xScheduledCommand != RELAY_CMD_NONE);
+    for (int i = 0; i < RELAYS_COUNT; i++) {
+        if (xCmd.xRelaySet.xCommands[i] != RELAY_CMD_NONE) {
+            xCmd.xRelaySet.xSource = CMD_SRC_MQTT;
+            bRelayEnqueue(&xCmd.xRelaySet);
+            break;
+        }
     }
 
-    if (pxPayload.hasOwnProperty("l2_state")) {
-        strcpy(pcState, (const char*) pxPayload["l2_state"]);
-        xRelays[1].xScheduledCommand = xParseRelayCommand(pcState);
-        xRelays[1].bScheduledCommandChanged = (xRelays[1].xScheduledCommand != RELAY_CMD_NONE);
+    if (xCmd.uiAutoOffMask) {
+        uint16_t uiAutoOffSecs[RELAYS_COUNT];
+        for (int i = 0; i < RELAYS_COUNT; i++) {
+            if (xCmd.uiAutoOffMask & (1 << i)) xRelays[i].uiAutoOffAfterSecs = xCmd.uiAutoOffSecs[i];
+            uiAutoOffSecs[i] = xRelays[i].uiAutoOffAfterSecs;
+        }
+        vFlashStorePut(&xFlashStore, FS_KEY_AUTOOFF, uiAutoOffSecs, sizeof(uiAutoOffSecs));
     }
 
-    if (pxPayload.hasOwnProperty("l3_state")) {
-        strcpy(pcState, (const char*) pxPayload["l3_state"]);
-        xRelays[2].xScheduledCommand = xParseRelayCommand(pcState);
-        xRelays[2].bScheduledCommandChanged = (xRelays[2].xScheduledCommand != RELAY_CMD_NONE);
+    switch (xCmd.xCommand) {
+    case MSG_CMD_STATUS:
+        uiReportBits |= SR_WAITING | SR_DEVINFO | SR_RELAYS | SR_FULL;
+        break;
+#if NR_PROFILER
+    case MSG_CMD_STATS:
+        uiStatsNext = 0;
+        break;
+#endif
+#if NR_LATENCY_STATS
+    case MSG_CMD_LATENCY:
+        uiLatencyNext = 0;
+        break;
+#endif
+#if NR_POWER_POLICY
+    case MSG_CMD_POWER:
+        bPowerReportPending = true;
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+// Binary state frame of the relays now, for MQTT and LAN replies
+void vBinaryStateFill(bin_state_t * pxState, uint16_t uiSeq) {
+    pxState->uiFlags = bExternalControlEnabled ? BIN_FLAG_EXTERNAL_CONTROL : 0;
+    pxState->uiSeq = uiSeq;
+    pxState->uiRelaysCount = RELAYS_COUNT;
+    pxState->uiExitCode = uiExitCode;
+    pxState->uiStateMask = 0;
+    for (int i = 0; i < RELAYS_COUNT; i++) {
+        if (xRelays[i].uiState == RELAY_STATE_ON) pxState->uiStateMask |= (1 << i);
     }
+    pxState->ulUptimeMs = millis();
+}
 
-    if (pxPayload.hasOwnProperty("command")) {
-        char pcCommand[20];
-        strcpy(pcCommand, (const char*) pxPayload["command"]);
-        if ((strcmp(pcCommand, "STATUS") == 0) || (strcmp(pcCommand, "status") == 0)) {
-            uiReportBits |= SR_WAITING | SR_DEVINFO;
-        } 
+// false if the command addresses no relay
+bool bBinaryCommandSet(const bin_command_t * pxBin, relay_command_set_t * pxSet) {
+    memset(pxSet, 0, sizeof(relay_command_set_t));
+    pxSet->uiSeq = pxBin->uiSeq;
+    bool bAny = false;
+    for (int i = 0; i < RELAYS_COUNT; i++) {
+        uint16_t uiBit = 1 << i;
+        if (!(pxBin->uiRelayMask & uiBit)) continue;
+        if (pxBin->uiToggleMask & uiBit) pxSet->xCommands[i] = RELAY_CMD_TOGGLE;
+        else pxSet->xCommands[i] = (pxBin->uiStateMask & uiBit) ? RELAY_CMD_ON : RELAY_CMD_OFF;
+        bAny = true;
     }
+    return bAny;
+}
+
+#if NR_MQTT_BINARY
+void vPublishBinaryState(uint16_t uiSeq) {
+    bin_state_t xState;
+    uint8_t pcFrame[BIN_STATE_LEN];
+    vBinaryStateFill(&xState, uiSeq);
+    vPublishBinary(pcFrame, uiBinEncodeState(pcFrame, &xState));
+}
+
+void vBinaryCB(char* pcTopic, char* pcPayload, size_t len) {
+    bin_command_t xBin;
+    if (!bBinDecodeCommand((const uint8_t *)pcPayload, len, &xBin)) {
+        LOG_WARN("[ vBinaryCB ] Bad frame, %u bytes", len);
+        return;
+    }
+    vBenchOnMessage();
+    relay_command_set_t xSet;
+    bool bAny = bBinaryCommandSet(&xBin, &xSet);
+    xSet.xSource = CMD_SRC_MQTT_BINARY;
+    // State frame goes out after the command is executed, see vRelayCommandScheduledHandler
+    if (!bAny || !bRelayEnqueue(&xSet)) {
+        if (xBin.uiFlags & BIN_FLAG_STATUS) vPublishBinaryState(xBin.uiSeq);
+    }
+}
+#endif
+
+#if NR_MQTT_GROUP
+static_assert(GROUP_OP_ON == RELAY_CMD_ON && GROUP_OP_OFF == RELAY_CMD_OFF && GROUP_OP_TOGGLE == RELAY_CMD_TOGGLE, "group ops");
+
+// Scene for many devices at once, most frames are for somebody else and cost one bit test
+void vGroupCB(char* pcTopic, char* pcPayload, size_t len) {
+    group_command_t xGroup;
+    if (!bGroupDecode((const uint8_t *)pcPayload, len, NR_GROUP_DEVICE_INDEX, NR_GROUP_MASK, &xGroup)) return;
+    vBenchOnMessage();
+    relay_command_set_t xSet;
+    memset(&xSet, 0, sizeof(xSet));
+    xSet.xSource = CMD_SRC_MQTT;
+    bool bAny = false;
+    for (int i = 0; i < RELAYS_COUNT; i++) {
+        xSet.xCommands[i] = (relay_command_t)uiGroupOp(&xGroup, i);
+        if (xSet.xCommands[i] != RELAY_CMD_NONE) bAny = true;
+    }
+    if (bAny) bRelayEnqueue(&xSet);
+}
+#endif
+
+#if NR_MQTT_CHANNEL_TOPICS
+// Raw "ON"/"OFF"/"TOGGLE" on a per-channel topic, no JSON
+void vChannelCommand(uint8_t uiRelayIdx, const char * pcPayload, size_t len) {
+    json_token_t xState = { pcPayload, (uint16_t)len, JSON_TYPE_STRING };
+    relay_command_t xCommand = xParseRelayCommand(&xState);
+    if (xCommand == RELAY_CMD_NONE) return;
+    vBenchOnMessage();
+    relay_command_set_t xSet;
+    memset(&xSet, 0, sizeof(xSet));
+    xSet.xSource = CMD_SRC_MQTT;
+    xSet.xCommands[uiRelayIdx] = xCommand;
+    bRelayEnqueue(&xSet);
+}
 
-    delete pxPayload;
-    // Serial.printf("4.free mem:\t%d\n", system_get_free_heap_size());
+template <uint8_t CHANNEL>
+void vChannelSetCB(char* pcTopic, char* pcPayload, size_t len) {
+    vChannelCommand(CHANNEL, pcPayload, len);
 }
 
+#define CHANNEL_ROUTE(n, relay, button)     TOPIC_ROUTE(NR_MQTT_CHANNEL_TOPIC #n "/set", vChannelSetCB<n - 1>),
+#endif
+
+#if NR_SCHEDULE
+static_assert(SCHED_CMD_ON == RELAY_CMD_ON && SCHED_CMD_OFF == RELAY_CMD_OFF && SCHED_CMD_TOGGLE == RELAY_CMD_TOGGLE, "schedule commands");
+
+schedule_t xSchedule;
+wheel_timer_t xScheduleTimer;
+
+void vScheduleRun(uint32_t ulArg);
+
+// New table over MQTT. It is saved and applied from loop(), flash writes do not belong in SYS.
+void vScheduleCB(char* pcTopic, char* pcPayload, size_t len) {
+    schedule_table_t xTable;
+    uint8_t uiFailed = uiScheduleParse(&xTable, pcPayload, len, RELAYS_COUNT);
+    if (uiFailed) {
+        LOG_WARN("[ vScheduleCB ] Bad schedule entry %i", uiFailed);
+        char pcReply[32];
+        report_writer_t xReply;
+        vReportBegin(&xReply, pcReply, sizeof(pcReply));
+        vReportAddInt(&xReply, "schedule_error", uiFailed);
+        vPublishReport(pcReply, uiReportEnd(&xReply));
+        return;
+    }
+    xSchedule.xTable = xTable;
+    xSchedule.bDirty = true;
+    vTimerArm(&xTimerWheel, &xScheduleTimer, 0, vScheduleRun);
+}
+
+void vScheduleFire() {
+    relay_command_set_t xSet;
+    memset(&xSet, 0, sizeof(xSet));
+    for (uint8_t i = 0; i < xSchedule.xTable.uiCount; i++) {
+        const sched_entry_t * pxEntry = &xSchedule.xTable.xEntries[i];
+        if (!bScheduleEntryDue(&xSchedule, pxEntry)) continue;
+        xSet.xCommands[uiSchedChannel(pxEntry)] = (relay_command_t)uiSchedCommand(pxEntry);
+    }
+    LOG_INFO("[ vScheduleFire ] %02d:%02d", xSchedule.uiNextMinute / 60, xSchedule.uiNextMinute % 60);
+    bRelayEnqueue(&xSet);
+}
+
+// Sleeps on the timer wheel until the next deadline, waking up at least every
+// SCHEDULE_TASK_DELAY_MS to notice the clock being set or corrected
+void vScheduleRun(uint32_t ulArg) {
+    uint32_t ulWaitMs = SCHEDULE_TASK_DELAY_MS;
+    bool bChanged = xSchedule.bDirty;
+    if (bChanged) {
+        vScheduleSeal(&xSchedule);
+        vFlashStorePut(&xFlashStore, FS_KEY_SCHEDULE, &xSchedule.xTable, sizeof(schedule_table_t));
+        xSchedule.bDirty = false;
+        xSchedule.tNext = 0;
+    }
+    if (timeStatus() != timeNotSet) {
+        time_t tNow = now();
+        if (xSchedule.tNext != 0 && tNow >= xSchedule.tNext) {
+            if ((uint32_t)(tNow - xSchedule.tNext) < SECS_PER_MIN) vScheduleFire();     // not if the clock jumped over it
+            xSchedule.tNext = 0;
+        }
+        if (xSchedule.tNext == 0) tScheduleNext(&xSchedule, tNow);
+        if (xSchedule.tNext != 0 && (uint32_t)(xSchedule.tNext - tNow) < ulWaitMs / 1000) {
+            ulWaitMs = (xSchedule.tNext - tNow) * 1000UL;
+        }
+    }
+    if (bChanged) {
+        LOG_INFO("[ vScheduleRun ] %i entries saved", xSchedule.xTable.uiCount);
+        char pcReply[64];
+        report_writer_t xReply;
+        vReportBegin(&xReply, pcReply, sizeof(pcReply));
+        vReportAddInt(&xReply, "schedule_entries", xSchedule.xTable.uiCount);
+        vReportAddInt(&xReply, "schedule_next", (uint32_t)xSchedule.tNext);
+        vPublishReport(pcReply, uiReportEnd(&xReply));
+    }
+    vTimerArm(&xTimerWheel, &xScheduleTimer, ulWaitMs, vScheduleRun);
+}
+#endif
+
+#if NR_LATENCY_STATS
+wheel_timer_t xRttProbeTimer;
+
+void vRttProbeCB(uint32_t ulArg) {
+    if (!mqttClient.connected()) return;
+    char pcProbe[12];
+    size_t uiLen = uiRttProbeStart(&xRttProbe, pcProbe, sizeof(pcProbe), millis());
+    vPublishLight(NR_MQTT_RTT_TOPIC, pcProbe, uiLen);
+}
+
+void vRttEchoCB(char* pcTopic, char* pcPayload, size_t len) {
+    uint32_t ulRttMs;
+    if (bRttProbeEcho(&xRttProbe, pcPayload, millis(), &ulRttMs)) vLatAdd(LAT_BROKER_RTT, ulRttMs);
+}
+#endif
+
+#if NR_OTA_HTTP
+ota_t xOta;
+wheel_timer_t xOtaRestartTimer;
+
+void vOtaReply(const char * pcState) {
+    char pcReply[160];
+    report_writer_t xReply;
+    vReportBegin(&xReply, pcReply, sizeof(pcReply));
+    vReportAddStr(&xReply, "ota", pcState);
+    if (xOta.xState == OTA_FAILED) {
+        vReportAddStr(&xReply, "ota_error", xOta.pcError);
+        vReportAddInt(&xReply, "ota_code", xOta.iErrorCode);
+    }
+    if (xOta.xState == OTA_DONE || xOta.xState == OTA_FAILED) {
+        vReportAddInt(&xReply, "ota_bytes", xOta.ulReceived);
+        vReportAddInt(&xReply, "ota_ms", xOta.ulFinishedAt - xOta.ulStartedAt);
+        vReportAddInt(&xReply, "ota_bps", ulOtaThroughput(&xOta));
+        vReportAddInt(&xReply, "ota_resumes", xOta.uiResumes);
+    }
+    vPublishReport(pcReply, uiReportEnd(&xReply));
+}
+
+// {"url":"...","size":N,"md5":"...","encoding":"heatshrink"}, see ota_routine.h
+void vOtaCB(char* pcTopic, char* pcPayload, size_t len) {
+    json_cursor_t xCur;
+    json_token_t xKey, xValue;
+    json_token_t xUrl = {}, xMd5 = {};
+    uint32_t ulSize = 0;
+    bool bHeatshrink = false;
+    if (!bJsonBegin(&xCur, pcPayload, len)) return;
+    while (bJsonNextMember(&xCur, &xKey, &xValue)) {
+        if (bJsonTokenEq(&xKey, "url") && xValue.xType == JSON_TYPE_STRING) xUrl = xValue;
+        else if (bJsonTokenEq(&xKey, "md5") && xValue.xType == JSON_TYPE_STRING) xMd5 = xValue;
+        else if (bJsonTokenEq(&xKey, "size") && xValue.xType == JSON_TYPE_NUMBER) ulSize = strtoul(xValue.pc, NULL, 10);
+        else if (bJsonTokenEq(&xKey, "encoding")) bHeatshrink = bJsonTokenEq(&xValue, "heatshrink");
+    }
+    if (xCur.bError || xMd5.uiLen != 32 || !bOtaStart(&xOta, xUrl.pc, xUrl.uiLen, ulSize, xMd5.pc, bHeatshrink)) {
+        LOG_WARN("[ vOtaCB ] OTA refused");
+        vOtaReply(bOtaBusy(&xOta) ? "busy" : "bad request");
+        return;
+    }
+    LOG_INFO("[ vOtaCB ] OTA from %s", xOta.pcUrl);
+    vOtaReply("started");
+}
+#endif
+
+constexpr topic_route_t xTopicRoutes[] = {
+    TOPIC_ROUTE(NR_MQTT_PING_TOPIC, vPingCB),
+    TOPIC_ROUTE(NR_MQTT_SET_TOPIC, vMessageCB),
+#if NR_MQTT_BINARY
+    TOPIC_ROUTE(NR_MQTT_BIN_SET_TOPIC, vBinaryCB),
+#endif
+#if NR_MQTT_GROUP
+    TOPIC_ROUTE(NR_MQTT_GROUP_TOPIC, vGroupCB),
+#endif
+#if NR_MQTT_CHANNEL_TOPICS
+    CHANNELS(CHANNEL_ROUTE)
+#endif
+#if NR_SCHEDULE
+    TOPIC_ROUTE(NR_MQTT_SCHEDULE_TOPIC, vScheduleCB),
+#endif
+#if NR_LATENCY_STATS
+    TOPIC_ROUTE(NR_MQTT_RTT_TOPIC, vRttEchoCB),
+#endif
+#if NR_OTA_HTTP
+    TOPIC_ROUTE(NR_MQTT_OTA_TOPIC, vOtaCB),
+#endif
+};
+static_assert(sizeof(xTopicRoutes) / sizeof(xTopicRoutes[0]) * 2 <= ROUTER_BUCKETS, "raise ROUTER_BUCKETS for this many routes");
+
+#if NR_MQTT_PERSISTENT
+uint16_t uiRetainedStates = 0;      // as last published to the channel state topics
+uint16_t uiRetainedKnown = 0;       // channels whose retained state is on the broker
+uint16_t uiRetainedUnacked = 0;     // sent, no PUBACK for uiRetainedPacketId yet
+uint16_t uiRetainedPacketId = 0;
+
+// Called from loop(). Publishes every channel whose retained state is missing or stale.
+void vRetainedStateHandler() {
+    if (!mqttClient.connected()) return;
+    vChannelsUnroll<RELAYS_COUNT>([&](uint8_t i) {
+        uint16_t uiBit = 1 << i;
+        bool bOn = (xRelays[i].uiState == RELAY_STATE_ON);
+        if ((uiRetainedKnown & uiBit) && ((uiRetainedStates & uiBit) != 0) == bOn) return;
+        uint16_t uiPacketId = vPublishRetained(xChannels[i].pcStateTopic, bOn ? "ON" : "OFF");
+        if (uiPacketId == 0) return;    // no room in the client right now, try on the next pass
+        uiRetainedPacketId = uiPacketId;
+        uiRetainedUnacked |= uiBit;
+        uiRetainedKnown |= uiBit;
+        uiRetainedStates = bOn ? (uiRetainedStates | uiBit) : (uiRetainedStates & ~uiBit);
+    });
+}
+
+bool bRetainedStatePending() {
+    uint16_t uiStates = 0;
+    for (uint8_t i = 0; i < RELAYS_COUNT; i++) {
+        if (xRelays[i].uiState == RELAY_STATE_ON) uiStates |= 1 << i;
+    }
+    return uiRetainedKnown != (1 << RELAYS_COUNT) - 1 || uiRetainedStates != uiStates;
+}
+#endif
+
 void vNetEventCB(net_event_code_t xEventCode) {
     // Serial.printf("[ vNetEventCB ] Event code %i\n", uiEventCode);
     switch (xEventCode) {
     case NE_WIFI_CONNECTED:
         vBlink(3);
         break;
+    case NE_MQTT_CONNECTED:
+        bJournalReplayPending = true;
+#if NR_MQTT_PERSISTENT
+        if (!bMqttSessionPresent) uiRetainedKnown = 0;     // a fresh broker may have lost them too
+#endif
+        if (ulBootReportMs == 0) uiReportBits |= SR_WAITING | SR_DEVINFO | SR_RELAYS | SR_FULL;   // first connect since boot
+        break;
     case NE_MQTT_DISCONNECTED:
         // vBlink(5);
+        vReportSchedReset(&xReportSched);
+        xJournal.uiReplayPacketId = 0;
+#if NR_MQTT_PERSISTENT
+        uiRetainedKnown &= ~uiRetainedUnacked;  // the library does not resend them
+        uiRetainedUnacked = 0;
+#endif
         bExternalControlEnabled = false;    
     default:
         break;
@@ -230,129 +740,512 @@ void vNetEventCB(net_event_code_t xEventCode) {
 
 }
 
-void vStateReportHandler() {
-    if (!(uiReportBits & SR_WAITING)) return;
+void vPublishAckCB(uint16_t uiPacketId) {
+    if (bJournalAck(&xJournal, uiPacketId)) {
+        bJournalReplayPending = xJournal.xHeader.uiCount || xJournal.xHeader.uiLost;    // added while it was in flight
+        return;
+    }
+#if NR_MQTT_PERSISTENT
+    if (uiPacketId == uiRetainedPacketId) {     // acks come in order, the earlier ones are in as well
+        uiRetainedUnacked = 0;
+        return;
+    }
+#endif
+    uint32_t ulSentAt;
+    if (bReportSchedAck(&xReportSched, uiPacketId, &ulSentAt)) LATENCY_SAMPLE(LAT_PUBACK, millis() - ulSentAt);
+}
+
+void vJournalEvent(journal_event_type_t xType, uint16_t uiData) {
+    vJournalAppend(&xJournal, xType, uiData, now(), timeStatus() == timeNotSet);
+}
+
+// Sends everything collected while offline, once per connection
+void vJournalHandler() {
+    if (!bJournalReplayPending || !mqttClient.connected()) return;
+    size_t uiLen = uiJournalFormat(&xJournal, pcJournalBuf, sizeof(pcJournalBuf));
+    if (uiLen == 0) {
+        bJournalReplayPending = false;
+        return;
+    }
+    uint16_t uiPacketId = vPublishReport(pcJournalBuf, uiLen);
+    if (uiPacketId == 0) return;    // no room in the client right now, try on the next pass
+    LOG_INFO("[ vJournalHandler ] Replayed %i offline events", xJournal.uiReplayCount);
+    vJournalReplaySent(&xJournal, uiPacketId);
+    bJournalReplayPending = false;
+}
+
+// Builds and publishes the pending report right away. Relays are only included
+// if their state differs from the newest one sent, unless SR_FULL is set.
+// If the client has no room for it, the bits stay pending for the next pass.
+void vStateReportFlush() {
+    PROFILE_SCOPE(PROF_STATE_REPORT);
+    if (ulBootReportMs == 0) ulBootReportMs = millis();
     uint8_t uiBits = uiReportBits;
     uiReportBits = 0;
-    JSONVar pxReport;
-    // char cBuf[32];
-
-    if (uiBits & SR_PONG) { pxReport["pong"] = (double)iPingPayload; }
-    if (uiBits & SR_RELAY1) { pxReport["l1_state"] = (xRelays[0].uiState == RELAY_STATE_ON) ? "ON" : "OFF"; }
-    if (uiBits & SR_RELAY2) { pxReport["l2_state"] = (xRelays[1].uiState == RELAY_STATE_ON) ? "ON" : "OFF"; }
-    if (uiBits & SR_RELAY3) { pxReport["l3_state"] = (xRelays[2].uiState == RELAY_STATE_ON) ? "ON" : "OFF"; }
-    if (uiBits & SR_EXIT_CODE) { pxReport["exit_code"] = uiExitCode; }
+    uint16_t uiRelayMask = 0;
+    uint16_t uiRelayStates = 0;
+    report_writer_t xReport;
+    vReportBegin(&xReport, pcReportBuf, sizeof(pcReportBuf));
+
+    if (uiBits & SR_PONG) { vReportAddInt(&xReport, "pong", iPingPayload); }
+    if (uiBits & SR_RELAYS) {
+        bool bFull = uiBits & SR_FULL;
+        vChannelsUnroll<RELAYS_COUNT>([&](uint8_t i) {
+            uint16_t uiBit = 1 << i;
+            bool bOn = (xRelays[i].uiState == RELAY_STATE_ON);
+            if (!bFull && bReportSchedKnown(&xReportSched, i, bOn)) return;
+            uiRelayMask |= uiBit;
+            if (bOn) uiRelayStates |= uiBit;
+            vReportAddStr(&xReport, xChannels[i].pcStateKey, bOn ? "ON" : "OFF");
+        });
+    }
+    if (uiBits & SR_EXIT_CODE) { vReportAddInt(&xReport, "exit_code", uiExitCode); }
     if (uiBits & SR_DEVINFO) { 
-        pxReport["device_id"] = NR_DEVICE_ID; 
-        pxReport["device_alias"] = NR_DEVICE_ALIAS; 
-        pxReport["ip_address"] = WiFi.localIP().toString(); 
+        vReportAddStr(&xReport, "device_id", NR_DEVICE_ID); 
+        vReportAddStr(&xReport, "device_alias", NR_DEVICE_ALIAS); 
+        vReportAddIp(&xReport, "ip_address", (uint32_t)WiFi.localIP()); 
+        vReportAddInt(&xReport, "cmd_queue", uiQueueDepth(&xRelayQueue));
+        vReportAddInt(&xReport, "cmd_queue_max", xRelayQueue.uiDepthMax);
+        vReportAddInt(&xReport, "cmd_dropped", xRelayQueue.ulDropped);
+        vReportAddInt(&xReport, "cmd_latency_us", ulActuateLatencyUs);
+        vReportAddInt(&xReport, "cmd_latency_max_us", ulActuateLatencyMaxUs);
+        vReportAddInt(&xReport, "boot_mqtt_ms", ulBootMqttMs);
+        vReportAddInt(&xReport, "boot_report_ms", ulBootReportMs);
+        vReportAddInt(&xReport, "boot_fast", bBootFast);
+        vReportAddInt(&xReport, "flash_store", xFlashStore.ulBase != 0);
     }
+    if (xReport.uiLen == 1) return;     // only '{', every relay is already known to the backend
     
-    String sReport = JSON.stringify(pxReport);
-    Serial.printf("[ vStateReport ] Report prepared! %s\n", sReport.c_str());
-    vPublishReport(sReport);
-    delete pxReport;
-}
-
-void vReadButtonsIO() {
-    for (int i = 0; i < BUTTONS_COUNT; i++) {
-        xButtons[i].uiRead = digitalRead(xButtons[i].uiPin);
-        if (xButtons[i].uiRead != xButtons[i].uiState) {
-            uint32_t ulNow = millis(); 
-            xButtons[i].ulPrevStateDuration = ulNow - xButtons[i].ulChangedAt;
-            xButtons[i].ulChangedAt = ulNow;
-            xButtons[i].bChanged = true;
-            xButtons[i].uiState = xButtons[i].uiRead;
-        }
+    size_t uiLen = uiReportEnd(&xReport);
+    LOG_DEBUG("[ vStateReport ] Report prepared! %s", pcReportBuf);
+    uint16_t uiPacketId = vPublishReport(pcReportBuf, uiLen);
+    if (uiPacketId == 0) {
+        uiReportBits |= uiBits;
+        return;
     }
+    vReportSchedSent(&xReportSched, uiPacketId, uiRelayMask, uiRelayStates, millis());
 }
 
-void vReadButtonsHandler() {
-    vReadButtonsIO();
+// Called from loop(). While offline the bits are kept and go out after reconnect.
+void vStateReportHandler() {
+    if (!(uiReportBits & SR_WAITING)) return;
+    if (!mqttClient.connected()) return;
+    if (!bReportSchedReady(&xReportSched, millis())) return;
+    vStateReportFlush();
+}
 
-    for (int i = 0; i < BUTTONS_COUNT; i++) {
-        if (xButtons[i].bChanged) {
-            xButtons[i].bChanged = false;
-            Serial.printf("[ vReadButtonsHandler ] Button %i changed => %i\n", i, xButtons[i].uiState);
-            if (xButtons[i].uiState == BUTTON_STATE_PUSH) {
-                xRelays[i].xScheduledCommand = RELAY_CMD_TOGGLE;
-                xRelays[i].bScheduledCommandChanged = true;
-            }
+void vButtonGestureCB(uint8_t uiButtonIdx, button_gesture_t xGesture) {
+    LOG_INFO("[ vButtonGestureCB ] Button %i: %s (%u ms)", uiButtonIdx, pcButtonGestureNames[xGesture], xButtons[uiButtonIdx].ulPrevStateDuration);
+    const button_action_t * pxAction = &xButtonActions[uiButtonIdx][xGesture];
+    switch (pxAction->xType) {
+    case BTN_ACTION_RELAY: {
+        relay_command_set_t xSet;
+        memset(&xSet, 0, sizeof(xSet));
+        xSet.xCommands[pxAction->uiRelayIdx] = pxAction->xCommand;
+#if NR_POWER_POLICY
+        xSet.ulEventAt = xButtons[uiButtonIdx].ulChangedAt;     // the edge, the wake from sleep included
+#endif
+        bRelayEnqueue(&xSet);
+        break;
+    }
+    case BTN_ACTION_MQTT: {
+        if (!mqttClient.connected()) {
+            vJournalEvent(JE_BUTTON, (uiButtonIdx << 4) | xGesture);
+            break;
         }
+        char pcEvent[48];
+        report_writer_t xEvent;
+        vReportBegin(&xEvent, pcEvent, sizeof(pcEvent));
+        vReportAddInt(&xEvent, "button", uiButtonIdx + 1);
+        vReportAddStr(&xEvent, "gesture", pcButtonGestureNames[xGesture]);
+        vPublishReport(pcEvent, uiReportEnd(&xEvent));
+        break;
+    }
+    default:
+        break;
     }
 }
 
-void vAutoOffCB(uint8_t uiRelayIdx) {
+void vAutoOffCB(uint32_t ulRelayIdx) {
     if (bExternalControlEnabled) return;
-    Serial.printf("[ vAutoOffCB ] Relay %i turned OFF!\n", uiRelayIdx);
-    xRelays[uiRelayIdx].xScheduledCommand = RELAY_CMD_OFF;
-    xRelays[uiRelayIdx].bScheduledCommandChanged = true;
+    LOG_INFO("[ vAutoOffCB ] Relay %u turned OFF!", ulRelayIdx);
+    bRelayEnqueueOne(ulRelayIdx, RELAY_CMD_OFF);
+}
 
+// Sets all masked GPIO0..15 outputs with one write of the GPO register,
+// so every relay of the batch switches at the same instant
+void vGpioWriteBatch(uint16_t uiMask, uint16_t uiValue) {
+    uint32_t ulSavedPS = xt_rsil(15);   // nothing else may touch GPO between read and write
+    GPO = (GPO & ~(uint32_t)uiMask) | (uiValue & uiMask);
+    xt_wsr_ps(ulSavedPS);
 }
 
-void vRelayCommandScheduledHandler() {
+// Computes the target state of every relay from one command set and applies it at once
+void vRelayApplySet(const relay_command_set_t * pxSet) {
+    uint32_t ulNow = millis();
+    uint16_t uiMask = 0;
+    uint16_t uiValue = 0;
+    uint16_t uiStates = 0;
+    bool bAny = false;
+    vChannelsUnroll<RELAYS_COUNT>([&](uint8_t i) {
+        uint8_t uiCurrState = xRelays[i].uiState;
+        switch (pxSet->xCommands[i]) {
+        case RELAY_CMD_NONE:
+            if (uiCurrState == RELAY_STATE_ON) uiStates |= 1 << i;
+            return;
+        case RELAY_CMD_ON:
+            xRelays[i].uiState = RELAY_STATE_ON;
+            break;        
+        case RELAY_CMD_OFF:
+            xRelays[i].uiState = RELAY_STATE_OFF;
+            break;
+        case RELAY_CMD_TOGGLE:
+            xRelays[i].uiState = !uiCurrState;
+            break;
+        }
+        bAny = true;
+        if (xRelays[i].uiState != uiCurrState) {
+            xRelays[i].ulChangedAt = ulNow; // Фиксируем только реальное изменение состояния
+        }
+        if (xRelays[i].uiState == RELAY_STATE_ON) uiStates |= 1 << i;
+        if (xChannels[i].uiRelayPin < 16) {
+            uiMask |= 1 << xChannels[i].uiRelayPin;
+            if (xRelays[i].uiState == HIGH) uiValue |= 1 << xChannels[i].uiRelayPin;
+        } else {
+            digitalWrite(xChannels[i].uiRelayPin, xRelays[i].uiState);    // GPIO16 has its own register
+        }
+    });
+    if (!bAny) return;
+    vGpioWriteBatch(uiMask, uiValue);
+    vBenchOnActuate();
+    uiReportBits |= SR_WAITING | SR_RELAYS;
+    vSessionSaveRelays(&xNetSession, uiStates);
+    vFlashStorePut(&xFlashStore, FS_KEY_RELAYS, &uiStates, sizeof(uiStates));
+    if (!mqttClient.connected()) vJournalEvent(JE_RELAYS, uiStates);
+    LOG_INFO("[ vRelayApplySet ] Relays set to 0x%04x", uiStates);
+
     for (int i = 0; i < RELAYS_COUNT; i++) {
-        if (xRelays[i].bScheduledCommandChanged) {
-            uint8_t uiCurrState = digitalRead(xRelays[i].uiPin);
-            xRelays[i].bScheduledCommandChanged = false;
-            switch (xRelays[i].xScheduledCommand) {
-            case RELAY_CMD_NONE:
-                continue;
-            case RELAY_CMD_ON:
-                xRelays[i].uiState = RELAY_STATE_ON;
-                break;        
-            case RELAY_CMD_OFF:
-                xRelays[i].uiState = RELAY_STATE_OFF;
-                break;
-            case RELAY_CMD_TOGGLE:
-                xRelays[i].uiState = !uiCurrState;
-                break;
-            }
-            if (xRelays[i].xScheduledCommand != RELAY_CMD_NONE) {
-                if (xRelays[i].uiState != uiCurrState) {
-                    xRelays[i].ulChangedAt = millis(); // Фиксируем только реальное изменение состояния
-                }
-                digitalWrite(xRelays[i].uiPin, xRelays[i].uiState);
-                uiReportBits |= SR_WAITING | xRelays[i].uiReportBit;
-                Serial.printf("[ vRelayCommandScheduledHandler ] Relay %i set to %i\n", i, xRelays[i].uiState);
-                if (xRelays[i].uiState == RELAY_STATE_ON && !bExternalControlEnabled && xRelays[i].uiAutoOffAfterSecs > 0) {
-                    Serial.printf("[ vRelayCommandScheduledHandler ] AutoOff for Relay %i scheduled after %i secs\n", i, xRelays[i].uiAutoOffAfterSecs);
-                    xRelays[i].xAutoOffTimer.once(xRelays[i].uiAutoOffAfterSecs, vAutoOffCB, (uint8_t)i);
-                }
+        if (pxSet->xCommands[i] == RELAY_CMD_NONE) continue;
+        if (xRelays[i].uiState == RELAY_STATE_ON && !bExternalControlEnabled && xRelays[i].uiAutoOffAfterSecs > 0) {
+            LOG_DEBUG("[ vRelayApplySet ] AutoOff for Relay %i scheduled after %i secs", i, xRelays[i].uiAutoOffAfterSecs);
+            vTimerArm(&xTimerWheel, &xRelays[i].xAutoOffTimer, xRelays[i].uiAutoOffAfterSecs * 1000UL, vAutoOffCB, i);
+        }
+    }
+}
+
+// Drains the command queue, called from loop() so a command is executed on the next pass
+void vRelayCommandScheduledHandler() {
+    if (uiQueueDepth(&xRelayQueue) == 0) return;
+    PROFILE_SCOPE(PROF_RELAY_COMMAND);
+    relay_command_set_t xSet;
+    while (bQueuePop(&xRelayQueue, &xSet)) {
+        vRelayApplySet(&xSet);
+        ulActuateLatencyUs = micros() - xSet.ulEnqueuedAt;
+        if (ulActuateLatencyUs > ulActuateLatencyMaxUs) ulActuateLatencyMaxUs = ulActuateLatencyUs;
+        LATENCY_SAMPLE(LAT_CMD_ACTUATE, ulActuateLatencyUs);
+#if NR_POWER_POLICY
+        vPowerActuated(&xPower, xSet.xPowerState, millis() - xSet.ulEventAt);
+#endif
+#if NR_MQTT_BINARY
+        if (xSet.xSource == CMD_SRC_MQTT_BINARY) vPublishBinaryState(xSet.uiSeq);
+#endif
+    }
+}
+
+#if NR_LAN_CONTROL
+// Runs in loop() like the executor, so a command is applied and answered in the same pass,
+// after whatever was queued before it
+void vLanHandler() {
+    lan_request_t xReq;
+    for (uint8_t n = 0; n < LAN_POLL_MAX && bLanPoll(&xReq); n++) {
+        uint16_t uiSeq = 0;
+        if (xReq.uiType == LAN_FRAME_COMMAND) {
+            vBenchOnMessage();
+            relay_command_set_t xSet;
+            if (bBinaryCommandSet(&xReq.xCommand, &xSet)) {
+                xSet.xSource = CMD_SRC_LAN;
+                bRelayEnqueue(&xSet);
+                vRelayCommandScheduledHandler();
             }
+            uiSeq = xReq.xCommand.uiSeq;
         }
+        bin_state_t xState;
+        vBinaryStateFill(&xState, uiSeq);
+        vLanReply(&xReq, &xState);
     }
 }
+#endif
+
+#if NR_PROFILER
+// One STATS report per loop() pass, so the client never has to take them all at once
+void vStatsHandler() {
+    if (uiStatsNext == STATS_NONE || !mqttClient.connected()) return;
+    char pcStats[448];
+    report_writer_t xStats;
+    vReportBegin(&xStats, pcStats, sizeof(pcStats));
+    if (uiStatsNext < PROF_SLOTS_COUNT) {
+        const prof_slot_t * pxSlot = &xProfSlots[uiStatsNext];
+        vReportAddStr(&xStats, "stats", pcProfSlotNames[uiStatsNext]);
+        vReportAddInt(&xStats, "calls", pxSlot->ulCalls);
+        vReportAddInt(&xStats, "min_us", ulProfCyclesToUs(pxSlot->ulMinCycles));
+        vReportAddInt(&xStats, "avg_us", pxSlot->ulCalls ? ulProfCyclesToUs(pxSlot->ullSumCycles / pxSlot->ulCalls) : 0);
+        vReportAddInt(&xStats, "max_us", ulProfCyclesToUs(pxSlot->ulMaxCycles));
+        vReportPutKey(&xStats, "hist_log2_us");
+        vReportPutChar(&xStats, '[');
+        for (uint8_t i = 0; i < PROF_BUCKETS; i++) {
+            if (i) vReportPutChar(&xStats, ',');
+            vReportPutUInt(&xStats, pxSlot->ulHist[i]);
+        }
+        vReportPutChar(&xStats, ']');
+    } else {
+        vProfSampleHeap();
+        vReportAddStr(&xStats, "stats", "heap");
+        vReportAddInt(&xStats, "free", ESP.getFreeHeap());
+        vReportAddInt(&xStats, "free_min", ulProfHeapLow);
+        vReportAddInt(&xStats, "max_block", ESP.getMaxFreeBlockSize());
+        vReportAddInt(&xStats, "fragmentation", ESP.getHeapFragmentation());
+        vReportAddInt(&xStats, "uptime_ms", millis());
+        vReportAddInt(&xStats, "timers_fired", xTimerWheel.ulFired);
+        vReportAddInt(&xStats, "timer_lag_max_ms", xTimerWheel.ulLagMaxMs);
+        vReportAddInt(&xStats, "flash_records", xFlashStore.ulRecords);
+        vReportAddInt(&xStats, "flash_compactions", xFlashStore.ulCompactions);
+        vReportAddInt(&xStats, "mqtt_chunked", xMqttReasm.ulChunked);
+        vReportAddInt(&xStats, "mqtt_oversized", xMqttReasm.ulOversized);
+        vReportAddInt(&xStats, "mqtt_aborted", xMqttReasm.ulAborted);
+#if NR_LAN_CONTROL
+        vReportAddInt(&xStats, "lan_accepted", xLanControl.ulAccepted);
+        vReportAddInt(&xStats, "lan_rejected", xLanControl.ulRejected);
+#endif
+    }
+    if (vPublishReport(pcStats, uiReportEnd(&xStats)) == 0) return;     // retry on the next pass
+    uiStatsNext = (uiStatsNext < PROF_SLOTS_COUNT) ? uiStatsNext + 1 : STATS_NONE;
+}
+#endif
+
+#if NR_LATENCY_STATS
+// One LATENCY report per loop() pass, like STATS
+void vLatencyHandler() {
+    if (uiLatencyNext == LATENCY_NONE || !mqttClient.connected()) return;
+    const lat_hist_t * pxHist = &xLatHists[uiLatencyNext];
+    char pcLatency[320];
+    report_writer_t xLatency;
+    vReportBegin(&xLatency, pcLatency, sizeof(pcLatency));
+    vReportAddStr(&xLatency, "latency", pcLatHistNames[uiLatencyNext]);
+    vReportAddInt(&xLatency, "count", pxHist->ulCount);
+    vReportAddInt(&xLatency, "min", pxHist->ulMin);
+    vReportAddInt(&xLatency, "avg", pxHist->ulCount ? (uint32_t)(pxHist->ullSum / pxHist->ulCount) : 0);
+    vReportAddInt(&xLatency, "max", pxHist->ulMax);
+    if (uiLatencyNext == LAT_BROKER_RTT) {
+        vReportAddInt(&xLatency, "probes_sent", xRttProbe.ulSent);
+        vReportAddInt(&xLatency, "probes_lost", xRttProbe.ulLost);
+    }
+    vReportPutKey(&xLatency, "hist_log2");
+    vReportPutChar(&xLatency, '[');
+    for (uint8_t i = 0; i < LAT_BUCKETS; i++) {
+        if (i) vReportPutChar(&xLatency, ',');
+        vReportPutUInt(&xLatency, pxHist->ulHist[i]);
+    }
+    vReportPutChar(&xLatency, ']');
+    if (vPublishReport(pcLatency, uiReportEnd(&xLatency)) == 0) return;     // retry on the next pass
+    uiLatencyNext = (uiLatencyNext + 1 < LAT_HISTS_COUNT) ? uiLatencyNext + 1 : LATENCY_NONE;
+}
+#endif
+
+#if NR_OTA_HTTP
+void vOtaRestartCB(uint32_t ulArg) {
+    ESP.restart();
+}
+
+void vOtaHandler() {
+    ota_state_t xPrev = xOta.xState;
+    if (xOtaRun(&xOta) == xPrev) return;
+    switch (xOta.xState) {
+    case OTA_DONE:
+        vOtaReply("done");
+        vTimerArm(&xTimerWheel, &xOtaRestartTimer, 1000, vOtaRestartCB);    // let the report out first
+        break;
+    case OTA_FAILED:
+        vOtaReply("failed");
+        break;
+    default:
+        break;
+    }
+}
+#endif
+
+#if NR_POWER_POLICY
+// Residency and worst wake-to-actuation time per state, for the "POWER" command.
+// Kept apart from STATS, so it works with the profiler compiled out.
+void vPowerReportHandler() {
+    if (!bPowerReportPending || !mqttClient.connected()) return;
+    uint32_t ulNow = millis();
+    char pcPower[320];
+    report_writer_t xReport;
+    vReportBegin(&xReport, pcPower, sizeof(pcPower));
+    vReportAddStr(&xReport, "power", pcPowerStateNames[xPower.xState]);
+    vReportAddInt(&xReport, "active_ms", ulPowerResidencyMs(&xPower, PWR_ACTIVE, ulNow));
+    vReportAddInt(&xReport, "modem_ms", ulPowerResidencyMs(&xPower, PWR_MODEM, ulNow));
+    vReportAddInt(&xReport, "light_ms", ulPowerResidencyMs(&xPower, PWR_LIGHT, ulNow));
+    vReportAddInt(&xReport, "transitions", xPower.ulTransitions);
+    vReportAddInt(&xReport, "wake_active_max_ms", xPower.ulWakeLatencyMaxMs[PWR_ACTIVE]);
+    vReportAddInt(&xReport, "wake_modem_max_ms", xPower.ulWakeLatencyMaxMs[PWR_MODEM]);
+    vReportAddInt(&xReport, "wake_light_max_ms", xPower.ulWakeLatencyMaxMs[PWR_LIGHT]);
+    if (vPublishReport(pcPower, uiReportEnd(&xReport)) == 0) return;    // retry on the next pass
+    bPowerReportPending = false;
+}
+
+bool bPowerWakeCheck() {
+    if (xPower.bWake) return true;
+    for (uint8_t i = 0; i < BUTTONS_COUNT; i++) {
+        if (xButtons[i].bEdge) return true;
+    }
+    return false;
+}
+
+// Last in loop(): anything left to do keeps the device active, otherwise the state follows
+// the idle time and the rest of the pass is slept away
+void vPowerHandler() {
+    bool bBusy = xPower.bWake || uiQueueDepth(&xRelayQueue) || bButtonsActive(xButtons, BUTTONS_COUNT) ||
+                 (uiReportBits & SR_WAITING) || xReportSched.uiInflight || bJournalReplayPending ||
+                 uiQueueDepth(&xLogRing) || uiLogLineSent != uiLogLineLen;
+#if NR_PROFILER
+    bBusy = bBusy || uiStatsNext != STATS_NONE;
+#endif
+#if NR_LATENCY_STATS
+    bBusy = bBusy || uiLatencyNext != LATENCY_NONE;
+#endif
+#if NR_OTA_HTTP
+    bBusy = bBusy || bOtaBusy(&xOta);
+#endif
+    bBusy = bBusy || bPowerReportPending;
+#if NR_MQTT_PERSISTENT
+    bBusy = bBusy || (mqttClient.connected() && bRetainedStatePending());
+#endif
+    xPower.bWake = false;
+    uint32_t ulNow = millis();
+    power_state_t xTarget = xPowerTarget(&xPower, bBusy, ulNow);
+    if (xTarget != xPower.xState) {
+        if (xPower.xState == PWR_LIGHT) vButtonsWakeDisarm();
+        LOG_DEBUG("[ vPowerHandler ] %s -> %s", pcPowerStateNames[xPower.xState], pcPowerStateNames[xTarget]);
+        vPowerSet(&xPower, xTarget, ulNow);
+        if (xTarget == PWR_LIGHT) vButtonsWakeArm();
+    }
+    // Armed timers are not busy, the ping watch always is armed: the sleep ends at the next one instead
+    vPowerIdle(&xPower, bPowerWakeCheck, ulTimerWheelNextMs(&xTimerWheel, POWER_LIGHT_SLICE_MS));
+}
+#endif
 
 void setup() {
     Serial.begin(115200);
-    Serial.printf("\n\n\n");
-    Serial.printf("====================================================\n");
-    Serial.printf("Welcome! Device " NR_DEVICE_ID " prepared to run... \n");
-    Serial.printf("====================================================\n\n");
+    Serial.print(F("\n\n\n"
+                   "====================================================\n"
+                   "Welcome! Device " NR_DEVICE_ID " prepared to run... \n"
+                   "====================================================\n\n"));
 
-    pinMode(PIN_RELAY1, OUTPUT); digitalWrite(PIN_RELAY1, RELAY_STATE_OFF);
-    pinMode(PIN_RELAY2, OUTPUT); digitalWrite(PIN_RELAY2, RELAY_STATE_OFF);
-    pinMode(PIN_RELAY3, OUTPUT); digitalWrite(PIN_RELAY3, RELAY_STATE_OFF);
+    vTimerWheelBegin(&xTimerWheel);
+    vJournalBegin(&xJournal);
+
+    for (int i = 0; i < RELAYS_COUNT; i++) {
+        pinMode(xChannels[i].uiRelayPin, OUTPUT); digitalWrite(xChannels[i].uiRelayPin, RELAY_STATE_OFF);
+    }
+    // Back to the relay states from before: RTC after a reset, the flash store after a power cycle
+    uint16_t uiRestoreStates = 0;
+    bool bRestore = false;
+    if (bSessionBegin(&xNetSession)) {
+        bBootFast = xNetSession.uiFlags & SESSION_WIFI;
+        bRestore = xNetSession.uiFlags & SESSION_RELAYS;
+        uiRestoreStates = xNetSession.uiRelayStates;
+    }
+#if NR_FLASH_STORE
+    if (bFlashStoreBegin(&xFlashStore)) {
+        uint16_t uiAutoOffSecs[RELAYS_COUNT];
+        if (bFlashStoreGet(&xFlashStore, FS_KEY_AUTOOFF, uiAutoOffSecs, sizeof(uiAutoOffSecs))) {
+            for (int i = 0; i < RELAYS_COUNT; i++) xRelays[i].uiAutoOffAfterSecs = uiAutoOffSecs[i];
+        }
+        if (!bRestore) bRestore = bFlashStoreGet(&xFlashStore, FS_KEY_RELAYS, &uiRestoreStates, sizeof(uiRestoreStates));
+    } else {
+        LOG_ERROR("[ setup ] No flash for the store, the filesystem area must be 8 KB or more, see flash_store.h");
+    }
+#endif
+    if (bRestore && uiRestoreStates) {
+        relay_command_set_t xSet;
+        memset(&xSet, 0, sizeof(xSet));
+        for (int i = 0; i < RELAYS_COUNT; i++) {
+            if (uiRestoreStates & (1 << i)) xSet.xCommands[i] = RELAY_CMD_ON;
+        }
+        vRelayApplySet(&xSet);
+    }
+
+#if NR_SCHEDULE
+    schedule_table_t xStoredTable;
+    bool bStored = bFlashStoreGet(&xFlashStore, FS_KEY_SCHEDULE, &xStoredTable, sizeof(xStoredTable));
+    vScheduleBegin(&xSchedule, bStored ? &xStoredTable : NULL);
+    LOG_INFO("[ setup ] Schedule: %i entries", xSchedule.xTable.uiCount);
+    vScheduleRun(0);
+#endif
+#if NR_SYNC_TIME_NTP
+    configTime(0, 0, NR_NTP_SERVER);
+    setSyncProvider(tNtpTime);
+#endif
 
     pinMode(PIN_WIFI_LED, OUTPUT); digitalWrite(PIN_WIFI_LED, LED_STATE_OFF); 
 
-    pinMode(PIN_BTN1, INPUT_PULLUP);
-    pinMode(PIN_BTN2, INPUT_PULLUP);
-    pinMode(PIN_BTN3, INPUT_PULLUP);
+    for (int i = 0; i < BUTTONS_COUNT; i++) {
+        xButtons[i].bDoubleEnabled = (xButtonActions[i][BTN_GESTURE_DOUBLE].xType != BTN_ACTION_NONE);
+    }
+    vButtonsBegin(xButtons, BUTTONS_COUNT);
 
-    xReadButtonsTimer.attach_ms(READ_BUTTONS_HANDLER_PERIOD_MS, vReadButtonsHandler);
-    xRelayCommandTimer.attach_ms(READ_BUTTONS_HANDLER_PERIOD_MS, vRelayCommandScheduledHandler);
-    xReportTimer.attach_ms(REPORT_HANDLER_SEND_MS, vStateReportHandler);
 
-    xNoPingWatchTimer.attach(WAIT_FOR_PING_SECS, vNoPingWatchHandler);
-    pvMessageCB = vMessageCB;
-    pvPingCB = vPingCB;
+    vTimerArm(&xTimerWheel, &xNoPingWatchTimer, WAIT_FOR_PING_SECS * 1000UL, vNoPingWatchHandler, 0, WAIT_FOR_PING_SECS * 1000UL);
+#if NR_LATENCY_STATS
+    vTimerArm(&xTimerWheel, &xRttProbeTimer, RTT_PROBE_INTERVAL_MS, vRttProbeCB, 0, RTT_PROBE_INTERVAL_MS);
+#endif
+    if (!bRouterBegin(&xTopicRouter, xTopicRoutes, sizeof(xTopicRoutes) / sizeof(xTopicRoutes[0]))) {
+        LOG_ERROR("[ setup ] Too many topic routes, ROUTER_BUCKETS is %d", ROUTER_BUCKETS);
+    }
+    pvPublishAckCB = vPublishAckCB;
+#if NR_POWER_POLICY
+    vPowerBegin(&xPower);
+#endif
     netSetup();
+#if NR_LAN_CONTROL
+    vLanBegin();
+#endif
     pvNetEventCB = vNetEventCB;
     // vBlink(3);
 }
 
 void loop() {
+   vTimerWheelRun(&xTimerWheel);
+   if (bButtonsActive(xButtons, BUTTONS_COUNT)) {
+       PROFILE_SCOPE(PROF_READ_BUTTONS);
+       vButtonsHandler(xButtons, BUTTONS_COUNT, vButtonGestureCB);
+   }
+   vRelayCommandScheduledHandler();
+#if NR_LAN_CONTROL
+   vLanHandler();
+#endif
+   vJournalHandler();
+   vStateReportHandler();
+#if NR_MQTT_PERSISTENT
+   vRetainedStateHandler();
+#endif
+#if NR_FLASH_STORE
+   vFlashStoreHandler(&xFlashStore);
+#endif
+#if NR_PROFILER
+   vStatsHandler();
+#endif
+#if NR_LATENCY_STATS
+   vLatencyHandler();
+#endif
    handleNetRoutine();
+#if NR_OTA_HTTP
+   vOtaHandler();
+#endif
+   vLogHandler();
+#if NR_POWER_POLICY
+   vPowerReportHandler();
+   vPowerHandler();
+#endif
 }
\ No newline at end of file
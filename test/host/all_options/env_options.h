@@ -0,0 +1,21 @@
+// Host build options with every feature on, so a combination that does not compile is caught.
+// Found before ../env_options.h by the bench_all_options target.
+#include <env_options_template.h>
+
+#undef NR_MQTT_BINARY
+#define NR_MQTT_BINARY      true
+#undef NR_MQTT_GROUP
+#define NR_MQTT_GROUP       true
+#undef NR_OTA_HTTP
+#define NR_OTA_HTTP         true
+#undef NR_OTA_PUBLIC_KEY
+#define NR_OTA_PUBLIC_KEY   "-----BEGIN PUBLIC KEY-----\nhost test, the stub does not parse it\n-----END PUBLIC KEY-----\n"
+#undef NR_LAN_CONTROL
+#define NR_LAN_CONTROL      true
+#undef NR_LAN_KEY
+#define NR_LAN_KEY          "host-test-lan-key-0123"
+#undef NR_POWER_POLICY
+#define NR_POWER_POLICY     true
+
+#undef NR_BENCHMARK
+#define NR_BENCHMARK        true
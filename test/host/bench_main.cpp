@@ -0,0 +1,166 @@
+// Latency/throughput benchmark of the "set message -> relay GPIO write -> report publish" path.
+// Runs the whole sketch on the host against the stubs: Wi-Fi and the broker are played by the stub
+// WiFi and AsyncMqttClient, relays are bits of the stub GPO register, time is simulated.
+//  - latency: the bench_routine.h hooks, in simulated time, one loop() pass taking BENCH_PASS_US.
+//    This is how long a command waits for the executor and the report coalescing;
+//  - cost: wall clock of the host CPU for the message callback and for the loop() passes;
+//  - heap: every operator new of the firmware is counted, peak per message and what is left over.
+// Usage: bench_command_path [messages]. Fails if a command or a report got lost, or heap leaked.
+#include <chrono>
+#include <malloc.h>
+#include <new>
+
+#include "../../src/ESP_SonOff_AsyncMQTT.cpp"
+
+#define BENCH_MESSAGES      300
+#define BENCH_PASS_US       1000
+
+// ----------- Heap accounting -----------------
+uint32_t ulHeapPeakUsed = 0;
+
+void * operator new(size_t uiSize) {
+    void * pv = malloc(uiSize ? uiSize : 1);
+    if (!pv) throw std::bad_alloc();
+    ulHostHeapUsed += malloc_usable_size(pv);
+    if (ulHostHeapUsed > ulHeapPeakUsed) ulHeapPeakUsed = ulHostHeapUsed;
+    return pv;
+}
+
+void operator delete(void * pv) noexcept {
+    if (!pv) return;
+    ulHostHeapUsed -= malloc_usable_size(pv);
+    free(pv);
+}
+
+void operator delete(void * pv, size_t) noexcept {
+    operator delete(pv);
+}
+
+// ----------- Driver -----------------
+typedef std::chrono::steady_clock bench_clock_t;
+
+typedef struct {
+    uint32_t ulMessages;
+    uint64_t ullMessageNs;          // wall clock in the MQTT message callback
+    uint64_t ullLoopNs;             // wall clock in loop() passes with the command or its report pending
+    uint32_t ulHeapPeakPerMsg;
+    int32_t iHeapLeak;
+    bench_live_t xLive;
+} bench_phase_t;
+
+uint64_t ullNsSince(bench_clock_t::time_point xStart) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock_t::now() - xStart).count();
+}
+
+void vPass(bench_phase_t * pxPhase) {
+    vHostAdvanceUs(BENCH_PASS_US);
+    bool bBusy = uiQueueDepth(&xRelayQueue) || (uiReportBits & SR_WAITING);
+    bench_clock_t::time_point xStart = bench_clock_t::now();
+    loop();
+    if (pxPhase && bBusy) pxPhase->ullLoopNs += ullNsSince(xStart);
+}
+
+void vPasses(uint32_t ulCount) {
+    for (uint32_t i = 0; i < ulCount; i++) vPass(NULL);
+    mqttClient.vHostAck();
+}
+
+uint16_t uiRelayStates() {
+    uint16_t uiStates = 0;
+    for (uint8_t i = 0; i < RELAYS_COUNT; i++) {
+        if ((GPO >> xChannels[i].uiRelayPin) & 1) uiStates |= 1 << i;
+    }
+    return uiStates;
+}
+
+// Every relay in turn, TOGGLE, ulSpacingMs apart, loop() passes in between. The PUBACKs come in
+// at the end of each slot. The hooks follow one command at a time, one that comes while the
+// previous is still waiting for its report is counted in that report.
+void vRunPhase(bench_phase_t * pxPhase, uint32_t ulMessages, uint32_t ulSpacingMs) {
+    memset(pxPhase, 0, sizeof(bench_phase_t));
+    memset(&xBenchLive, 0, sizeof(xBenchLive));
+    bBenchPending = false;
+    pxPhase->ulMessages = ulMessages;
+    uint32_t ulHeapStart = ulHostHeapUsed;
+    char pcPayload[48];
+    for (uint32_t n = 0; n < ulMessages; n++) {
+        uint32_t ulSlotEnd = millis() + ulSpacingMs;
+        size_t len = snprintf(pcPayload, sizeof(pcPayload), "{\"%s\":\"TOGGLE\"}", xChannels[n % RELAYS_COUNT].pcStateKey);
+        ulHeapPeakUsed = ulHostHeapUsed;
+        uint32_t ulHeapBefore = ulHostHeapUsed;
+
+        bench_clock_t::time_point xStart = bench_clock_t::now();
+        mqttClient.vHostMessage(mqttSetTopic, pcPayload, len);
+        pxPhase->ullMessageNs += ullNsSince(xStart);
+        while ((int32_t)(millis() - ulSlotEnd) < 0) vPass(pxPhase);
+
+        if (ulHeapPeakUsed - ulHeapBefore > pxPhase->ulHeapPeakPerMsg) pxPhase->ulHeapPeakPerMsg = ulHeapPeakUsed - ulHeapBefore;
+        mqttClient.vHostAck();
+    }
+    pxPhase->iHeapLeak = (int32_t)ulHostHeapUsed - (int32_t)ulHeapStart;
+    pxPhase->xLive = xBenchLive;
+}
+
+void vPrintStat(const char * pcName, const bench_stat_t * pxStat) {
+    printf("\"%s\":[%u,%u,%u,%u]", pcName, pxStat->ulCount, pxStat->ulMin, ulBenchStatAvg(pxStat), pxStat->ulMax);
+}
+
+void vPrintPhase(const char * pcName, uint32_t ulSpacingMs, const bench_phase_t * pxPhase) {
+    uint64_t ullNs = pxPhase->ullMessageNs + pxPhase->ullLoopNs;
+    printf("{\"phase\":\"%s\",\"spacing_ms\":%u,\"messages\":%u,", pcName, ulSpacingMs, pxPhase->ulMessages);
+    printf("\"msgs_per_sec\":%llu,\"message_cb_ns\":%llu,\"cpu_per_msg_ns\":%llu,",
+           (unsigned long long)(pxPhase->ullMessageNs ? (uint64_t)pxPhase->ulMessages * 1000000000ULL / pxPhase->ullMessageNs : 0),
+           (unsigned long long)(pxPhase->ullMessageNs / pxPhase->ulMessages), (unsigned long long)(ullNs / pxPhase->ulMessages));
+    printf("\"heap_peak_per_msg\":%u,\"heap_leak\":%d,", pxPhase->ulHeapPeakPerMsg, pxPhase->iHeapLeak);
+    vPrintStat("rx_to_actuate_us", &pxPhase->xLive.xRxToActuate);
+    printf(",");
+    vPrintStat("rx_to_publish_us", &pxPhase->xLive.xRxToPublish);
+    printf("}\n");
+}
+
+int main(int argc, char ** argv) {
+    uint32_t ulMessages = argc > 1 ? strtoul(argv[1], NULL, 10) : BENCH_MESSAGES;
+    ulMessages -= ulMessages % (2 * RELAYS_COUNT);  // every relay is toggled an even number of times
+    if (ulMessages == 0) ulMessages = 2 * RELAYS_COUNT;
+    mqttClient.bHostRecord = false;
+    mqttClient.xUnacked.reserve(64);
+
+    setup();
+    vPasses(10);
+    WiFi.vHostGotIp();
+    mqttClient.vHostConnect(false);
+    vPasses(2000);      // boot reports, retained states, flash store
+    uint16_t uiStatesBefore = uiRelayStates();
+
+    // Idle: the report pipe is free, each report goes out on the pass after the command.
+    // Burst: commands come faster than REPORT_COALESCE_MS, reports are merged.
+    const uint32_t ulIdleMs = REPORT_COALESCE_MS * 2;
+    const uint32_t ulBurstMs = REPORT_COALESCE_MS / 5;
+    bench_phase_t xIdle, xBurst;
+    vRunPhase(&xIdle, ulMessages, ulIdleMs);
+    vPasses(2000);
+    vRunPhase(&xBurst, ulMessages, ulBurstMs);
+    vPasses(2000);
+
+    vPrintPhase("idle", ulIdleMs, &xIdle);
+    vPrintPhase("burst", ulBurstMs, &xBurst);
+
+    int iFailures = 0;
+    if (xIdle.xLive.xRxToPublish.ulCount != ulMessages || xIdle.xLive.xRxToActuate.ulCount != ulMessages) {
+        printf("FAIL idle: every command must be actuated and reported on its own\n");
+        iFailures++;
+    }
+    if (xBurst.xLive.xRxToActuate.ulCount == 0 || xBurst.xLive.xRxToPublish.ulCount == 0) {
+        printf("FAIL burst: nothing actuated or reported\n");
+        iFailures++;
+    }
+    if (xIdle.iHeapLeak > 0 || xBurst.iHeapLeak > 0) {
+        printf("FAIL heap leaked\n");
+        iFailures++;
+    }
+    if (uiRelayStates() != uiStatesBefore || xRelayQueue.ulDropped != 0) {
+        printf("FAIL relays 0x%04x, were 0x%04x, %u commands dropped\n", uiRelayStates(), uiStatesBefore, xRelayQueue.ulDropped);
+        iFailures++;
+    }
+    return iFailures;
+}
@@ -0,0 +1,16 @@
+// Host build options: the template as shipped, then what the host can not or should not do.
+// The sketch includes this file in place of the user's env_options.h.
+#include <env_options_template.h>
+
+#undef NR_SYNC_TIME_NTP
+#define NR_SYNC_TIME_NTP    false       // host clock is simulated, the time comes from the test
+
+#undef NR_OTA_HTTP
+#define NR_OTA_HTTP         false       // off as shipped, all_options/env_options.h builds it
+#undef NR_LAN_CONTROL
+#define NR_LAN_CONTROL      false       // needs a key, all_options/env_options.h builds it
+#undef NR_POWER_POLICY
+#define NR_POWER_POLICY     false       // idle slices would skew the latencies
+
+#undef NR_BENCHMARK
+#define NR_BENCHMARK        true        // live hooks, read by bench_main.cpp
@@ -0,0 +1,283 @@
+#pragma once
+// Generated by hs_encode.py, do not edit. -w 10 -l 5 test image, not upstream encoded.
+#include <stdint.h>
+
+const uint8_t pcHsImage[3076] = {
+    0xE9, 0x01, 0x02, 0x40, 0x10, 0xF0, 0x10, 0x40, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x00,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x01, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x02,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x03, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x04,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x05, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x06,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x07, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x08,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x09, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x0A,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x0B, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x0C,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x0D, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x0E,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x0F, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x10,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x11, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x12,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x13, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x14,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x15, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x16,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x17, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x18,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x19, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x1A,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x1B, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x1C,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x1D, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x1E,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x1F, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x20,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x21, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x22,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x23, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x24,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x25, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x26,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x27, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x28,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x29, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x2A,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x2B, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x2C,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x2D, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x2E,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x2F, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x30,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x31, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x32,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x33, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x34,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x35, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x36,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x37, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x38,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x39, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x3A,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x3B, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x3C,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x3D, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x3E,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x3F, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x40,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x41, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x42,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x43, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x44,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x45, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x46,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x47, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x48,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x49, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x4A,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x4B, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x4C,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x4D, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x4E,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x4F, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x50,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x51, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x52,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x53, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x54,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x55, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x56,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x57, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x58,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x59, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x5A,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x5B, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x5C,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x5D, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x5E,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x5F, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x60,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x61, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x62,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x63, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x64,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x65, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x66,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x67, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x68,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x69, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x6A,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x6B, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x6C,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x6D, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x6E,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x6F, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x70,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x71, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x72,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x73, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x74,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x75, 0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x76,
+    0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, 0x77, 0x2F, 0x73, 0x6F, 0x6E, 0x6F, 0x66, 0x66, 0x2F,
+    0x72, 0x65, 0x6C, 0x61, 0x79, 0x2F, 0x73, 0x65, 0x74, 0x2F, 0x73, 0x6F, 0x6E, 0x6F, 0x66, 0x66,
+    0x2F, 0x72, 0x65, 0x6C, 0x61, 0x79, 0x2F, 0x73, 0x65, 0x74, 0x2F, 0x73, 0x6F, 0x6E, 0x6F, 0x66,
+    0x66, 0x2F, 0x72, 0x65, 0x6C, 0x61, 0x79, 0x2F, 0x73, 0x65, 0x74, 0x2F, 0x73, 0x6F, 0x6E, 0x6F,
+    0x66, 0x66, 0x2F, 0x72, 0x65, 0x6C, 0x61, 0x79, 0x2F, 0x73, 0x65, 0x74, 0x2F, 0x73, 0x6F, 0x6E,
+    0x6F, 0x66, 0x66, 0x2F, 0x72, 0x65, 0x6C, 0x61, 0x79, 0x2F, 0x73, 0x65, 0x74, 0x2F, 0x73, 0x6F,
+    0x6E, 0x6F, 0x66, 0x66, 0x2F, 0x72, 0x65, 0x6C, 0x61, 0x79, 0x2F, 0x73, 0x65, 0x74, 0x7B, 0x22,
+    0x6C, 0x31, 0x22, 0x3A, 0x22, 0x4F, 0x4E, 0x22, 0x2C, 0x22, 0x6C, 0x32, 0x22, 0x3A, 0x22, 0x4F,
+    0x46, 0x46, 0x22, 0x7D, 0x7B, 0x22, 0x6C, 0x31, 0x22, 0x3A, 0x22, 0x4F, 0x4E, 0x22, 0x2C, 0x22,
+    0x6C, 0x32, 0x22, 0x3A, 0x22, 0x4F, 0x46, 0x46, 0x22, 0x7D, 0x7B, 0x22, 0x6C, 0x31, 0x22, 0x3A,
+    0x22, 0x4F, 0x4E, 0x22, 0x2C, 0x22, 0x6C, 0x32, 0x22, 0x3A, 0x22, 0x4F, 0x46, 0x46, 0x22, 0x7D,
+    0x7B, 0x22, 0x6C, 0x31, 0x22, 0x3A, 0x22, 0x4F, 0x4E, 0x22, 0x2C, 0x22, 0x6C, 0x32, 0x22, 0x3A,
+    0x22, 0x4F, 0x46, 0x46, 0x22, 0x7D, 0x7B, 0x22, 0x6C, 0x31, 0x22, 0x3A, 0x22, 0x4F, 0x4E, 0x22,
+    0x2C, 0x22, 0x6C, 0x32, 0x22, 0x3A, 0x22, 0x4F, 0x46, 0x46, 0x22, 0x7D, 0x7B, 0x22, 0x6C, 0x31,
+    0x22, 0x3A, 0x22, 0x4F, 0x4E, 0x22, 0x2C, 0x22, 0x6C, 0x32, 0x22, 0x3A, 0x22, 0x4F, 0x46, 0x46,
+    0x22, 0x7D, 0x68, 0x65, 0x61, 0x74, 0x73, 0x68, 0x72, 0x69, 0x6E, 0x6B, 0x68, 0x65, 0x61, 0x74,
+    0x73, 0x68, 0x72, 0x69, 0x6E, 0x6B, 0x68, 0x65, 0x61, 0x74, 0x73, 0x68, 0x72, 0x69, 0x6E, 0x6B,
+    0x68, 0x65, 0x61, 0x74, 0x73, 0x68, 0x72, 0x69, 0x6E, 0x6B, 0x68, 0x65, 0x61, 0x74, 0x73, 0x68,
+    0x72, 0x69, 0x6E, 0x6B, 0x68, 0x65, 0x61, 0x74, 0x73, 0x68, 0x72, 0x69, 0x6E, 0x6B, 0x2F, 0x73,
+    0x6F, 0x6E, 0x6F, 0x66, 0x66, 0x2F, 0x72, 0x65, 0x6C, 0x61, 0x79, 0x2F, 0x73, 0x74, 0x61, 0x74,
+    0x65, 0x2F, 0x73, 0x6F, 0x6E, 0x6F, 0x66, 0x66, 0x2F, 0x72, 0x65, 0x6C, 0x61, 0x79, 0x2F, 0x73,
+    0x74, 0x61, 0x74, 0x65, 0x2F, 0x73, 0x6F, 0x6E, 0x6F, 0x66, 0x66, 0x2F, 0x72, 0x65, 0x6C, 0x61,
+    0x79, 0x2F, 0x73, 0x74, 0x61, 0x74, 0x65, 0x2F, 0x73, 0x6F, 0x6E, 0x6F, 0x66, 0x66, 0x2F, 0x72,
+    0x65, 0x6C, 0x61, 0x79, 0x2F, 0x73, 0x74, 0x61, 0x74, 0x65, 0x2F, 0x73, 0x6F, 0x6E, 0x6F, 0x66,
+    0x66, 0x2F, 0x72, 0x65, 0x6C, 0x61, 0x79, 0x2F, 0x73, 0x74, 0x61, 0x74, 0x65, 0x2F, 0x73, 0x6F,
+    0x6E, 0x6F, 0x66, 0x66, 0x2F, 0x72, 0x65, 0x6C, 0x61, 0x79, 0x2F, 0x73, 0x74, 0x61, 0x74, 0x65,
+    0x19, 0xCD, 0xC5, 0xF3, 0xE7, 0xB8, 0xF1, 0x91, 0xFB, 0x00, 0xEB, 0x10, 0x10, 0xDE, 0x40, 0x5E,
+    0x9E, 0x3F, 0x95, 0x38, 0x6A, 0x72, 0xEE, 0x2A, 0x4A, 0x69, 0x21, 0x11, 0xAA, 0xB8, 0x0A, 0x46,
+    0x6E, 0x08, 0x51, 0x71, 0xE8, 0x42, 0x74, 0xD4, 0xAC, 0xE1, 0x1A, 0xB9, 0x56, 0x17, 0x64, 0xCE,
+    0xC4, 0xC6, 0x00, 0x66, 0x29, 0x31, 0xD6, 0x9C, 0x9C, 0x23, 0xD1, 0x63, 0xF7, 0x91, 0xB5, 0x60,
+    0xB2, 0xB5, 0x29, 0xCA, 0x55, 0xDA, 0xAA, 0x48, 0xA3, 0x72, 0x06, 0xE7, 0x67, 0x78, 0x2C, 0x82,
+    0x32, 0xD1, 0x58, 0x75, 0x30, 0x83, 0xA4, 0x73, 0xFB, 0xA9, 0xBD, 0xF3, 0x19, 0x93, 0xFC, 0xAC,
+    0x90, 0x0E, 0xAB, 0x10, 0x18, 0x18, 0x98, 0xD7, 0x80, 0xAA, 0x2C, 0x87, 0x69, 0x46, 0x97, 0xD4,
+    0x3C, 0x0C, 0x90, 0x20, 0xA4, 0xA9, 0x90, 0xA9, 0x9E, 0xBB, 0x28, 0xB8, 0x60, 0x0B, 0x3B, 0x00,
+    0xDC, 0x4C, 0x5E, 0x45, 0x98, 0x9C, 0xE4, 0x3D, 0xFD, 0xBD, 0xAF, 0x53, 0x20, 0x14, 0x8E, 0xFB,
+    0x29, 0x0E, 0xB1, 0xF5, 0xFB, 0xD9, 0xC5, 0xD5, 0xD6, 0x7D, 0x46, 0x5E, 0xF8, 0x06, 0xE9, 0x23,
+    0x0E, 0x74, 0xF6, 0x8D, 0x1F, 0x32, 0xBD, 0xCC, 0xB0, 0x1E, 0x0E, 0x6F, 0x1D, 0x68, 0x30, 0x4C,
+    0xE5, 0xBB, 0x95, 0x2A, 0x5E, 0xCA, 0xFB, 0x3F, 0xC6, 0x3D, 0x89, 0x65, 0x47, 0xF8, 0x74, 0x64,
+    0x03, 0xCF, 0xDA, 0xCE, 0xBA, 0xDE, 0x58, 0xF1, 0xA2, 0xA1, 0x96, 0x45, 0x80, 0x87, 0xF5, 0x98,
+    0x82, 0x81, 0xAD, 0xF8, 0xAA, 0xC2, 0xED, 0x40, 0xBD, 0x26, 0xC7, 0xAB, 0xA5, 0x41, 0xDE, 0x15,
+    0x7B, 0x49, 0x1D, 0x36, 0xB4, 0xA4, 0x01, 0x8C, 0xEA, 0xB7, 0xA6, 0xB1, 0x15, 0x69, 0x58, 0x06,
+    0x0D, 0x2F, 0x3F, 0x5B, 0x4D, 0xEF, 0x66, 0x1B, 0x0D, 0xEF, 0x5F, 0x69, 0xD5, 0xCB, 0x0E, 0xD9,
+    0x16, 0xB8, 0x90, 0xCE, 0xB2, 0x57, 0x03, 0xE4, 0xF5, 0x38, 0xCF, 0x14, 0x54, 0x1F, 0x25, 0x35,
+    0xC1, 0x55, 0x9E, 0xFC, 0x29, 0x18, 0xD7, 0xD7, 0x9A, 0xB9, 0xDA, 0x68, 0x76, 0x99, 0xE9, 0xCC,
+    0x51, 0xAB, 0xD4, 0x0F, 0x4D, 0x97, 0x85, 0x53, 0xEC, 0x02, 0x24, 0xB9, 0xF2, 0x59, 0x72, 0x68,
+    0xE2, 0x6C, 0xA7, 0x11, 0x0D, 0xB4, 0xAA, 0xAD, 0x39, 0xE1, 0x99, 0xCB, 0x7E, 0x03, 0xC9, 0xA9,
+    0x19, 0x02, 0x66, 0x80, 0xBA, 0x71, 0x16, 0xA3, 0xED, 0xBD, 0x5A, 0x8E, 0xE5, 0xD2, 0x95, 0x9F,
+    0x12, 0xCF, 0x9C, 0xE4, 0x28, 0x0A, 0xB2, 0xD9, 0x77, 0x3F, 0xD5, 0x57, 0xF0, 0x4E, 0x3D, 0x04,
+    0x2B, 0xD4, 0xCE, 0x1B, 0xA4, 0x54, 0x31, 0x96, 0x87, 0x78, 0x5E, 0x5E, 0x80, 0xC2, 0x2E, 0x3E,
+    0xE1, 0x06, 0x5E, 0x7F, 0xC1, 0x8D, 0x4B, 0x8F, 0x3E, 0xDC, 0x6E, 0x1D, 0x9B, 0x46, 0xBF, 0x72,
+    0xB7, 0xDA, 0xF0, 0xA3, 0x55, 0xC3, 0x4A, 0xFA, 0x0C, 0xCF, 0x99, 0xAC, 0x5D, 0xF4, 0xF9, 0xAD,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x03, 0x00,
+    0x02, 0x03, 0x02, 0x02, 0x02, 0x03, 0x02, 0x02, 0x00, 0x03, 0x01, 0x03, 0x00, 0x00, 0x01, 0x01,
+    0x01, 0x01, 0x03, 0x03, 0x03, 0x00, 0x00, 0x00, 0x03, 0x00, 0x02, 0x00, 0x00, 0x01, 0x02, 0x01,
+    0x02, 0x02, 0x03, 0x00, 0x02, 0x00, 0x02, 0x01, 0x00, 0x00, 0x03, 0x02, 0x02, 0x00, 0x02, 0x03,
+    0x02, 0x03, 0x00, 0x03, 0x02, 0x01, 0x03, 0x03, 0x01, 0x03, 0x02, 0x03, 0x00, 0x01, 0x03, 0x03,
+    0x01, 0x00, 0x01, 0x03, 0x01, 0x01, 0x00, 0x01, 0x02, 0x01, 0x02, 0x00, 0x01, 0x02, 0x02, 0x03,
+    0x00, 0x02, 0x02, 0x02, 0x01, 0x01, 0x01, 0x03, 0x01, 0x00, 0x01, 0x02, 0x02, 0x00, 0x00, 0x00,
+    0x01, 0x02, 0x02, 0x02, 0x01, 0x02, 0x00, 0x01, 0x03, 0x03, 0x00, 0x00, 0x01, 0x03, 0x01, 0x01,
+    0x01, 0x03, 0x02, 0x00, 0x00, 0x00, 0x01, 0x01, 0x02, 0x03, 0x00, 0x02, 0x03, 0x00, 0x02, 0x00,
+    0x00, 0x00, 0x01, 0x00, 0x02, 0x00, 0x02, 0x02, 0x01, 0x03, 0x02, 0x03, 0x00, 0x02, 0x03, 0x00,
+    0x02, 0x02, 0x02, 0x01, 0x01, 0x00, 0x03, 0x03, 0x00, 0x01, 0x02, 0x01, 0x02, 0x03, 0x02, 0x01,
+    0x01, 0x01, 0x00, 0x02, 0x01, 0x01, 0x02, 0x02, 0x01, 0x03, 0x01, 0x01, 0x03, 0x02, 0x02, 0x01,
+    0x03, 0x01, 0x01, 0x03, 0x00, 0x01, 0x03, 0x02, 0x01, 0x02, 0x03, 0x00, 0x02, 0x01, 0x01, 0x00,
+    0x01, 0x01, 0x03, 0x01, 0x00, 0x01, 0x02, 0x00, 0x01, 0x00, 0x03, 0x03, 0x02, 0x01, 0x01, 0x00,
+    0x03, 0x03, 0x00, 0x01, 0x03, 0x03, 0x02, 0x02, 0x01, 0x02, 0x01, 0x02, 0x02, 0x03, 0x00, 0x02,
+    0x03, 0x01, 0x01, 0x03, 0x00, 0x02, 0x00, 0x02, 0x02, 0x02, 0x02, 0x00, 0x00, 0x01, 0x03, 0x01,
+    0x02, 0x03, 0x02, 0x02, 0x03, 0x00, 0x02, 0x00, 0x02, 0x01, 0x02, 0x01, 0x02, 0x03, 0x02, 0x00,
+    0x00, 0x02, 0x03, 0x01, 0x02, 0x01, 0x00, 0x01, 0x03, 0x02, 0x00, 0x01, 0x02, 0x03, 0x01, 0x01,
+    0x03, 0x00, 0x00, 0x00, 0x01, 0x03, 0x00, 0x01, 0x03, 0x01, 0x03, 0x00, 0x01, 0x01, 0x02, 0x00,
+    0x02, 0x03, 0x03, 0x01, 0x01, 0x03, 0x03, 0x02, 0x03, 0x02, 0x01, 0x02, 0x00, 0x02, 0x01, 0x03,
+    0x02, 0x03, 0x02, 0x03, 0x01, 0x03, 0x01, 0x03, 0x00, 0x02, 0x01, 0x03, 0x03, 0x03, 0x00, 0x00,
+    0x03, 0x01, 0x00, 0x00, 0x01, 0x01, 0x00, 0x03, 0x00, 0x02, 0x00, 0x03, 0x01, 0x01, 0x02, 0x02,
+    0x00, 0x02, 0x02, 0x02, 0x01, 0x02, 0x00, 0x00, 0x01, 0x03, 0x02, 0x00, 0x02, 0x03, 0x03, 0x03,
+    0x00, 0x01, 0x01, 0x03, 0x02, 0x01, 0x00, 0x01, 0x02, 0x00, 0x01, 0x01, 0x02, 0x01, 0x02, 0x01,
+    0x03, 0x03, 0x03, 0x02, 0x03, 0x00, 0x00, 0x00, 0x01, 0x03, 0x02, 0x00, 0x01, 0x00, 0x03, 0x02,
+    0x00, 0x00, 0x00, 0x02, 0x03, 0x01, 0x01, 0x02, 0x02, 0x01, 0x01, 0x03, 0x02, 0x01, 0x00, 0x01,
+    0x01, 0x00, 0x00, 0x00, 0x03, 0x01, 0x03, 0x03, 0x01, 0x02, 0x01, 0x03, 0x00, 0x03, 0x03, 0x03,
+    0x00, 0x00, 0x01, 0x03, 0x02, 0x01, 0x01, 0x01, 0x01, 0x03, 0x00, 0x00, 0x01, 0x02, 0x00, 0x02,
+    0x00, 0x03, 0x02, 0x03, 0x00, 0x02, 0x02, 0x03, 0x01, 0x03, 0x03, 0x00, 0x03, 0x03, 0x01, 0x00,
+    0x02, 0x01, 0x03, 0x00, 0x02, 0x01, 0x02, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03, 0x01,
+    0x02, 0x00, 0x02, 0x02, 0x00, 0x01, 0x02, 0x02, 0x02, 0x02, 0x03, 0x03, 0x03, 0x03, 0x00, 0x02,
+    0x00, 0x02, 0x00, 0x03, 0x01, 0x00, 0x00, 0x02, 0x02, 0x02, 0x00, 0x00, 0x03, 0x03, 0x03, 0x02,
+    0x03, 0x01, 0x01, 0x03, 0x01, 0x02, 0x03, 0x00, 0x00, 0x00, 0x03, 0x03, 0x02, 0x02, 0x03, 0x02,
+    0x00, 0x00, 0x00, 0x03, 0x01, 0x01, 0x01, 0x01, 0x02, 0x01, 0x02, 0x03, 0x01, 0x03, 0x00, 0x01,
+    0x02, 0x01, 0x01, 0x01, 0x02, 0x00, 0x02, 0x02, 0x01, 0x02, 0x00, 0x03, 0x00, 0x01, 0x02, 0x03,
+    0x03, 0x00, 0x03, 0x02, 0x03, 0x02, 0x03, 0x02, 0x02, 0x00, 0x00, 0x01, 0x00, 0x02, 0x03, 0x02,
+    0x01, 0x02, 0x00, 0x01, 0x03, 0x02, 0x01, 0x01, 0x01, 0x02, 0x01, 0x00, 0x02, 0x02, 0x03, 0x03,
+    0x00, 0x02, 0x02, 0x00, 0x02, 0x02, 0x01, 0x01, 0x01, 0x02, 0x03, 0x01, 0x00, 0x02, 0x02, 0x03,
+    0x03, 0x00, 0x03, 0x02,
+};
+
+const uint8_t pcHsImageEncoded[1291] = {
+    0xF4, 0xC0, 0x60, 0x54, 0x08, 0x87, 0xC2, 0x21, 0x40, 0x89, 0x70, 0x7E, 0x10, 0x99, 0x8F, 0x36,
+    0x05, 0x00, 0x00, 0xE6, 0x80, 0x80, 0x73, 0x40, 0x80, 0x39, 0xA0, 0x60, 0x1C, 0xD0, 0x40, 0x0E,
+    0x68, 0x28, 0x07, 0x34, 0x18, 0x03, 0x9A, 0x0E, 0x01, 0xCD, 0x08, 0x00, 0xE6, 0x84, 0x80, 0x73,
+    0x42, 0x80, 0x39, 0xA1, 0x60, 0x1C, 0xD0, 0xC0, 0x0E, 0x68, 0x68, 0x07, 0x34, 0x38, 0x03, 0x9A,
+    0x1E, 0x01, 0xCD, 0x10, 0x00, 0xE6, 0x88, 0x80, 0x73, 0x44, 0x80, 0x39, 0xA2, 0x60, 0x1C, 0xD1,
+    0x40, 0x0E, 0x68, 0xA8, 0x07, 0x34, 0x58, 0x03, 0x9A, 0x2E, 0x01, 0xCD, 0x18, 0x00, 0xE6, 0x8C,
+    0x80, 0x73, 0x46, 0x80, 0x39, 0xA3, 0x60, 0x1C, 0xD1, 0xC0, 0x0E, 0x68, 0xE8, 0x07, 0x34, 0x78,
+    0x03, 0x9A, 0x3E, 0x01, 0xCD, 0x20, 0x00, 0xE6, 0x90, 0x80, 0x73, 0x48, 0x80, 0x39, 0xA4, 0x60,
+    0x1C, 0xD2, 0x40, 0x0E, 0x69, 0x28, 0x07, 0x34, 0x98, 0x03, 0x9A, 0x4E, 0x01, 0xCD, 0x28, 0x00,
+    0xE6, 0x94, 0x80, 0x73, 0x4A, 0x80, 0x39, 0xA5, 0x60, 0x1C, 0xD2, 0xC0, 0x0E, 0x69, 0x68, 0x07,
+    0x34, 0xB8, 0x03, 0x9A, 0x5E, 0x01, 0xCD, 0x30, 0x00, 0xE6, 0x98, 0x80, 0x73, 0x4C, 0x80, 0x39,
+    0xA6, 0x60, 0x1C, 0xD3, 0x40, 0x0E, 0x69, 0xA8, 0x07, 0x34, 0xD8, 0x03, 0x9A, 0x6E, 0x01, 0xCD,
+    0x38, 0x00, 0xE6, 0x9C, 0x80, 0x73, 0x4E, 0x80, 0x39, 0xA7, 0x60, 0x1C, 0xD3, 0xC0, 0x0E, 0x69,
+    0xE8, 0x07, 0x34, 0xF8, 0x03, 0x9A, 0x7E, 0x01, 0xCC, 0x81, 0xCF, 0x41, 0x00, 0xE6, 0xA1, 0x00,
+    0x73, 0x50, 0xC0, 0x39, 0xA8, 0x80, 0x1C, 0xD4, 0x50, 0x0E, 0x6A, 0x30, 0x07, 0x35, 0x1C, 0x03,
+    0x9A, 0x90, 0x01, 0xCD, 0x49, 0x00, 0xE6, 0xA5, 0x00, 0x73, 0x52, 0xC0, 0x39, 0xA9, 0x80, 0x1C,
+    0xD4, 0xD0, 0x0E, 0x6A, 0x70, 0x07, 0x35, 0x3C, 0x03, 0x9A, 0xA0, 0x01, 0xCD, 0x51, 0x00, 0xE6,
+    0xA9, 0x00, 0x73, 0x54, 0xC0, 0x39, 0xAA, 0x80, 0x1C, 0xD5, 0x50, 0x0E, 0x6A, 0xB0, 0x07, 0x35,
+    0x5C, 0x03, 0x9A, 0xB0, 0x01, 0xCD, 0x59, 0x00, 0xE6, 0xAD, 0x00, 0x73, 0x56, 0xC0, 0x39, 0xAB,
+    0x80, 0x1C, 0xD5, 0xD0, 0x0E, 0x6A, 0xF0, 0x07, 0x35, 0x7C, 0x03, 0x9A, 0xC0, 0x01, 0xCD, 0x61,
+    0x00, 0xE6, 0xB1, 0x00, 0x73, 0x58, 0xC0, 0x39, 0xAC, 0x80, 0x1C, 0xD6, 0x50, 0x0E, 0x6B, 0x30,
+    0x07, 0x35, 0x9C, 0x03, 0x9A, 0xD0, 0x01, 0xCD, 0x69, 0x00, 0xE6, 0xB5, 0x00, 0x73, 0x5A, 0xC0,
+    0x39, 0xAD, 0x80, 0x1C, 0xD6, 0xD0, 0x0E, 0x6B, 0x70, 0x07, 0x35, 0xBC, 0x03, 0x9A, 0xE0, 0x01,
+    0xCD, 0x71, 0x00, 0xE6, 0xB9, 0x00, 0x73, 0x5C, 0xC0, 0x39, 0xAE, 0x80, 0x1C, 0xD7, 0x50, 0x0E,
+    0x6B, 0xB0, 0x07, 0x35, 0xDE, 0x5F, 0x73, 0xB7, 0xDB, 0xAD, 0xF6, 0x6B, 0x34, 0xBE, 0xE5, 0x65,
+    0xB6, 0x58, 0x6F, 0x32, 0xFB, 0x9D, 0x96, 0xE8, 0x04, 0x3E, 0x04, 0x3E, 0x04, 0x29, 0x7B, 0x91,
+    0x5B, 0x26, 0x32, 0x29, 0xD4, 0x8A, 0x9F, 0x4E, 0x91, 0x4B, 0x24, 0x56, 0xC9, 0x90, 0x09, 0x1D,
+    0x1A, 0x8D, 0x22, 0xBE, 0x81, 0x5F, 0x81, 0x5F, 0x81, 0x5F, 0x81, 0x56, 0xDA, 0x2C, 0xB6, 0x1B,
+    0xA5, 0xCE, 0xD1, 0x72, 0xB4, 0xDB, 0xAD, 0x60, 0x27, 0xE0, 0x26, 0x23, 0x41, 0xD7, 0x4B, 0x0D,
+    0xD2, 0xCA, 0x04, 0xBE, 0x04, 0xBE, 0x04, 0xBD, 0x19, 0xE6, 0xF1, 0x7E, 0x7E, 0x7D, 0xC7, 0xC7,
+    0x23, 0xFB, 0x80, 0x7A, 0xE2, 0x11, 0x0E, 0xF5, 0x02, 0xBD, 0x9E, 0x9F, 0xE5, 0x67, 0x16, 0xAB,
+    0x97, 0xBA, 0x55, 0x4A, 0xB4, 0xC8, 0x62, 0x3A, 0xAD, 0xC4, 0x2A, 0x8D, 0x6E, 0x84, 0x54, 0x6E,
+    0x3E, 0x8A, 0x15, 0xD3, 0xA9, 0xAC, 0xF0, 0xC6, 0xB7, 0x35, 0x68, 0xBD, 0x93, 0x9D, 0xC4, 0xE3,
+    0x40, 0x2C, 0xD2, 0x99, 0x8F, 0x5B, 0x39, 0x9C, 0x91, 0xF4, 0x6C, 0x7F, 0x7C, 0x8E, 0xD6, 0xC1,
+    0xB2, 0xDA, 0xCA, 0x79, 0x55, 0x5E, 0xD6, 0xAA, 0x91, 0xA3, 0xB9, 0x41, 0xBC, 0xF6, 0x7B, 0xC4,
+    0xB3, 0x05, 0x32, 0xE8, 0xD6, 0x2E, 0xB3, 0x0C, 0x1E, 0x92, 0xE7, 0xFB, 0xD4, 0xEF, 0x7E, 0x71,
+    0x9C, 0x9F, 0xF3, 0x59, 0x90, 0x87, 0x6A, 0xE2, 0x11, 0x88, 0xC6, 0x63, 0xAF, 0x80, 0xD5, 0x4B,
+    0x30, 0xF6, 0x9A, 0x36, 0x5F, 0xA9, 0x3C, 0x86, 0x64, 0x24, 0x1A, 0x4D, 0x4E, 0x43, 0x53, 0x9E,
+    0xDD, 0xCA, 0x37, 0x16, 0x08, 0x5C, 0xEE, 0x01, 0xDC, 0xA6, 0x57, 0xA8, 0xB9, 0x8C, 0xE7, 0x92,
+    0x7B, 0xFD, 0xDE, 0xEB, 0xEA, 0x72, 0x08, 0xA6, 0x3B, 0xF7, 0x29, 0x87, 0x6C, 0x7E, 0xBF, 0xBE,
+    0xCF, 0x17, 0xAB, 0xD6, 0xBE, 0xD1, 0xAB, 0xDF, 0x88, 0x37, 0xA6, 0x47, 0x0E, 0xBA, 0x7D, 0xB1,
+    0xB1, 0xF9, 0x96, 0xF7, 0x99, 0xB0, 0x8F, 0x43, 0xAD, 0xF1, 0xDB, 0x44, 0xC2, 0x99, 0xE5, 0xDD,
+    0xE5, 0x65, 0x55, 0xEE, 0x57, 0xEE, 0x7F, 0xC6, 0x9E, 0xE2, 0x6C, 0xB4, 0x7F, 0xC5, 0xD2, 0xC9,
+    0x03, 0xE7, 0xF6, 0xB9, 0xDB, 0xAE, 0xF5, 0x63, 0xE3, 0xA2, 0xD0, 0xE5, 0xA8, 0xB8, 0x0C, 0x3F,
+    0xD7, 0x31, 0x82, 0xC0, 0xEB, 0x7F, 0x1A, 0xAE, 0x17, 0xB6, 0x81, 0xBD, 0x93, 0x71, 0xF5, 0x7A,
+    0x5A, 0x0F, 0x7A, 0x2B, 0x7B, 0xA4, 0xC7, 0x66, 0xDB, 0x4D, 0x24, 0x07, 0x19, 0xEA, 0xDB, 0xE9,
+    0xB6, 0x31, 0x5B, 0x4D, 0x62, 0x0D, 0x0D, 0x97, 0xCF, 0xEB, 0x74, 0xDF, 0x7D, 0x9A, 0x37, 0x0D,
+    0xF7, 0xD7, 0xED, 0x3D, 0x5E, 0x5C, 0x3B, 0xB3, 0x16, 0xDC, 0x64, 0x39, 0xDB, 0x2A, 0xBC, 0x0F,
+    0xC9, 0xF5, 0x9C, 0x73, 0xE2, 0x95, 0x48, 0xFC, 0x96, 0x6B, 0xC1, 0xAA, 0xE7, 0xBF, 0x92, 0x98,
+    0xC7, 0x5F, 0xAF, 0x9A, 0xDC, 0xF6, 0xAD, 0x17, 0x6C, 0xCF, 0xA7, 0x99, 0x51, 0xD5, 0xF5, 0x21,
+    0xF4, 0xDC, 0xBE, 0x16, 0xA7, 0xEC, 0x81, 0x49, 0x37, 0x3F, 0x2A, 0xCD, 0xCA, 0xD1, 0xE2, 0xB6,
+    0x69, 0xE2, 0x30, 0xDD, 0xA6, 0xAB, 0x5B, 0x39, 0xF0, 0xE6, 0x79, 0x77, 0xE8, 0x1F, 0x27, 0x53,
+    0x19, 0x81, 0x59, 0xB0, 0x1B, 0xAB, 0x8C, 0x5B, 0x47, 0xED, 0xDE, 0xD6, 0xB1, 0xDE, 0x5E, 0x96,
+    0x57, 0x3F, 0x12, 0xE7, 0xE7, 0x3C, 0x92, 0x88, 0x56, 0xCB, 0xB3, 0x77, 0x9F, 0xF5, 0x6A, 0xFF,
+    0x0A, 0x74, 0xF6, 0x09, 0x2B, 0xEA, 0x73, 0xA3, 0x7A, 0x4A, 0xA4, 0xC7, 0x2D, 0x87, 0xBC, 0x57,
+    0xAB, 0xD8, 0x0E, 0x14, 0xBA, 0x7D, 0xE1, 0x83, 0x57, 0xAF, 0xFC, 0x1C, 0x6D, 0x2F, 0x1F, 0x3E,
+    0xEE, 0x5B, 0xA3, 0xB9, 0xBA, 0x36, 0xFE, 0xE5, 0xB7, 0xED, 0x7C, 0x34, 0x75, 0x5E, 0x1D, 0x2B,
+    0xF5, 0x0C, 0xE7, 0xE6, 0x75, 0x95, 0xDF, 0xA7, 0xE7, 0x5B, 0xFF, 0x00, 0x1F, 0x00, 0x1F, 0x00,
+    0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00,
+    0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00,
+    0x1F, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x1A, 0x80, 0x40, 0x20, 0x70, 0x08, 0x14, 0x0E, 0x05, 0x02,
+    0x00, 0x63, 0x80, 0x40, 0xE0, 0x30, 0x38, 0x04, 0x02, 0x02, 0x00, 0x05, 0x03, 0x81, 0x80, 0x81,
+    0x01, 0x91, 0x80, 0xE1, 0x40, 0xA0, 0x20, 0x70, 0x40, 0x24, 0x50, 0x28, 0x08, 0x11, 0x10, 0x24,
+    0x10, 0x29, 0x14, 0x0C, 0x04, 0x08, 0x11, 0x8A, 0x02, 0x02, 0x46, 0x01, 0xC6, 0x01, 0x05, 0x01,
+    0x00, 0x82, 0x05, 0x22, 0x00, 0x82, 0x05, 0x83, 0x81, 0x40, 0x82, 0x20, 0xC0, 0x90, 0xC2, 0x08,
+    0x80, 0x28, 0xC0, 0xD1, 0x02, 0xA0, 0xC1, 0x48, 0xC1, 0xB8, 0x80, 0xA8, 0xE0, 0x20, 0xA4, 0x61,
+    0x8C, 0x90, 0x08, 0x08, 0x5F, 0x18, 0x52, 0x10, 0x11, 0x30, 0x3E, 0x1C, 0x00, 0x16, 0x88, 0x28,
+    0x8C, 0x34, 0x88, 0x06, 0x08, 0x02, 0x08, 0x0F, 0x8C, 0x1D, 0x0C, 0x03, 0x14, 0x24, 0x08, 0x0E,
+    0x0C, 0x0C, 0x0C, 0x24, 0x88, 0x35, 0x10, 0x22, 0x8A, 0x06, 0x0B, 0x46, 0x0E, 0x48, 0x02, 0x44,
+    0x07, 0xC4, 0x23, 0x4A, 0x0B, 0xC8, 0x18, 0x06, 0x23, 0x46, 0x0A, 0xC4, 0x3A, 0xC6, 0x34, 0x4A,
+    0x17, 0xC9, 0x00, 0x04, 0x23, 0x1B, 0xA2, 0x12, 0xC3, 0x01, 0xE2, 0x05, 0x83, 0x04, 0xC3, 0x05,
+    0x23, 0x00, 0x82, 0x0A, 0xE2, 0x81, 0x0E, 0x21, 0x05, 0x01, 0x87, 0x11, 0x83, 0x41, 0x00, 0x81,
+    0x81, 0xA1, 0x05, 0x31, 0x92, 0x82, 0x87, 0xD1, 0x02, 0x71, 0x12, 0xE2, 0x02, 0x81, 0x12, 0x21,
+    0x8E, 0xF2, 0x05, 0x02, 0x03, 0xB1, 0x04, 0x41, 0x83, 0xA1, 0x0A, 0x12, 0x07, 0x11, 0x83, 0x41,
+    0x87, 0xF1, 0x01, 0xF2, 0x83, 0x61, 0x10, 0x01, 0x87, 0x61, 0x8F, 0x51, 0x82, 0x72, 0x04, 0xE1,
+    0x18, 0xA1, 0x89, 0x41, 0x96, 0x91, 0x13, 0x52, 0x90, 0x51, 0x99, 0xD2, 0x05, 0x21, 0x03, 0x21,
+    0x12, 0x41, 0x82, 0x21, 0x81, 0xE1, 0x11, 0xC1, 0x88, 0xA1, 0x99, 0xF1, 0x83, 0x92, 0x88, 0x01,
+    0x97, 0x42, 0x07, 0xC1, 0x8E, 0x82, 0x0A, 0x22, 0x0F, 0xE2, 0x07, 0xB2, 0x13, 0x01, 0x88, 0x12,
+    0x12, 0x51, 0x87, 0xF2, 0x19, 0x51, 0x90, 0xD2, 0x0F, 0x21, 0x86, 0xB1, 0x98, 0xF2, 0x03, 0x71,
+    0x11, 0x11, 0x9E, 0xE1, 0x80, 0x11, 0x8D, 0x21, 0x9F, 0xE1, 0x9C, 0xB2, 0x02, 0x42, 0x00, 0xE1,
+    0x01, 0xE1, 0x8F, 0x22, 0x00, 0xF1, 0x88, 0xC1, 0x82, 0xF2, 0x80,
+};
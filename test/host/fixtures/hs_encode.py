@@ -0,0 +1,117 @@
+#!/usr/bin/env python3
+# Writes heatshrink_image.h: a firmware-like test image and its -w 10 -l 5 encoding.
+# Not the upstream encoder, so this image only exercises chunking and the window carried
+# across feeds; conformance comes from the upstream vectors in test_heatshrink_vectors.cpp.
+# Greedy longest match in the window, a backref only when it is shorter than the literals,
+# bits MSB first, last byte zero padded. It gives the upstream vectors' bytes at their settings.
+# Usage: hs_encode.py > heatshrink_image.h
+import random
+
+WINDOW_BITS = 10
+LOOKAHEAD_BITS = 5
+MAX_OFFSET = 1 << WINDOW_BITS
+MAX_COUNT = 1 << LOOKAHEAD_BITS
+BREAK_EVEN = (1 + WINDOW_BITS + LOOKAHEAD_BITS) // 9 + 1
+
+
+class BitWriter:
+    def __init__(self):
+        self.out = bytearray()
+        self.byte = 0
+        self.bits = 0
+
+    def put(self, value, count):
+        for i in range(count - 1, -1, -1):
+            self.byte = (self.byte << 1) | ((value >> i) & 1)
+            self.bits += 1
+            if self.bits == 8:
+                self.out.append(self.byte)
+                self.byte = 0
+                self.bits = 0
+
+    def finish(self):
+        if self.bits:
+            self.out.append(self.byte << (8 - self.bits))
+        return bytes(self.out)
+
+
+def encode(data):
+    w = BitWriter()
+    i = 0
+    while i < len(data):
+        best_len, best_off = 0, 0
+        for off in range(1, min(i, MAX_OFFSET) + 1):
+            n = 0
+            while n < MAX_COUNT and i + n < len(data) and data[i + n - off] == data[i + n]:
+                n += 1
+            if n > best_len:
+                best_len, best_off = n, off
+                if n == MAX_COUNT:
+                    break
+        if best_len > BREAK_EVEN:
+            w.put(0, 1)
+            w.put(best_off - 1, WINDOW_BITS)
+            w.put(best_len - 1, LOOKAHEAD_BITS)
+            i += best_len
+        else:
+            w.put(1, 1)
+            w.put(data[i], 8)
+            i += 1
+    return w.finish()
+
+
+def decode(data):
+    out = bytearray()
+    bits = ''.join(format(b, '08b') for b in data)
+    p = 0
+    while True:
+        if p + 9 > len(bits) and (p >= len(bits) or bits[p] == '1'):
+            break
+        if bits[p] == '1':
+            out.append(int(bits[p + 1:p + 9], 2))
+            p += 9
+        else:
+            if p + 1 + WINDOW_BITS + LOOKAHEAD_BITS > len(bits):
+                break
+            off = int(bits[p + 1:p + 1 + WINDOW_BITS], 2) + 1
+            n = int(bits[p + 1 + WINDOW_BITS:p + 1 + WINDOW_BITS + LOOKAHEAD_BITS], 2) + 1
+            for _ in range(n):
+                out.append(out[-off])
+            p += 1 + WINDOW_BITS + LOOKAHEAD_BITS
+    return bytes(out)
+
+
+# Looks like a small firmware: a header, code-like repeats, strings, a 0xFF erased tail and
+# some noise, over 3 windows long so backrefs cross the window wrap.
+def image():
+    rng = random.Random(8266)
+    data = bytearray([0xE9, 0x01, 0x02, 0x40, 0x10, 0xF0, 0x10, 0x40])
+    for n in range(120):
+        data += bytes([0x12, 0xC1, 0xF0, 0x09, 0x31, 0xCD, 0x02, n & 0xFF])
+    for s in (b'/sonoff/relay/set', b'{"l1":"ON","l2":"OFF"}', b'heatshrink', b'/sonoff/relay/state'):
+        data += s * 6
+    data += bytes(rng.randrange(256) for _ in range(400))
+    data += b'\xff' * 700
+    data += bytes(rng.randrange(4) for _ in range(600))
+    return bytes(data)
+
+
+def c_array(name, data):
+    lines = ['const uint8_t %s[%d] = {' % (name, len(data))]
+    for i in range(0, len(data), 16):
+        lines.append('    ' + ', '.join('0x%02X' % b for b in data[i:i + 16]) + ',')
+    lines.append('};')
+    return '\n'.join(lines)
+
+
+if __name__ == '__main__':
+    raw = image()
+    enc = encode(raw)
+    assert decode(enc) == raw
+    print('#pragma once')
+    print('// Generated by hs_encode.py, do not edit. -w %d -l %d test image, not upstream encoded.' % (WINDOW_BITS, LOOKAHEAD_BITS))
+    print('#include <stdint.h>')
+    print()
+    print(c_array('pcHsImage', raw))
+    print()
+    print(c_array('pcHsImageEncoded', enc))
@@ -0,0 +1,49 @@
+#pragma once
+// Minimal test runner for the host tests: TEST(name) { ... CHECK(expr); CHECK_EQ(a, b); }
+// One executable per module, main() runs every TEST of the file, the exit code is the failure count.
+#include <stdio.h>
+#include <stdint.h>
+
+typedef void (*host_test_fn_t)();
+
+typedef struct {
+    const char * pcName;
+    host_test_fn_t pvFn;
+} host_test_t;
+
+inline host_test_t xHostTests[64];
+inline int iHostTestsCount = 0;
+inline int iHostFailures = 0;
+
+struct host_test_register_t {
+    host_test_register_t(const char * pcName, host_test_fn_t pvFn) { xHostTests[iHostTestsCount++] = { pcName, pvFn }; }
+};
+
+#define TEST(name) \
+    void vTest_##name(); \
+    host_test_register_t xTestReg_##name(#name, vTest_##name); \
+    void vTest_##name()
+
+#define CHECK(expr) do { \
+        if (!(expr)) { \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+            iHostFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) do { \
+        long long llA = (long long)(a), llB = (long long)(b); \
+        if (llA != llB) { \
+            printf("%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, llA, llB); \
+            iHostFailures++; \
+        } \
+    } while (0)
+
+int main() {
+    for (int i = 0; i < iHostTestsCount; i++) {
+        int iBefore = iHostFailures;
+        xHostTests[i].pvFn();
+        printf("%s %s\n", iHostFailures == iBefore ? "PASS" : "FAIL", xHostTests[i].pcName);
+    }
+    return iHostFailures ? 1 : 0;
+}
@@ -0,0 +1,251 @@
+#pragma once
+// Host stand-in for the ESP8266 Arduino core, only what the firmware uses.
+// Time is simulated: nothing moves until the test calls vHostAdvanceMs()/vHostAdvanceUs().
+// GPIO is a set of variables, GPO included, no pin is ever driven.
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <algorithm>
+#include <random>
+#include <string>
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH            1
+#define LOW             0
+#define INPUT           0x00
+#define INPUT_PULLUP    0x02
+#define OUTPUT          0x01
+#define CHANGE          3
+#define LED_BUILTIN     2
+
+#define BIT0    0x00000001
+#define BIT1    0x00000002
+#define BIT2    0x00000004
+#define BIT3    0x00000008
+#define BIT4    0x00000010
+#define BIT5    0x00000020
+#define BIT6    0x00000040
+#define BIT7    0x00000080
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define PROGMEM
+#define PSTR(s)     (s)
+#define F(s)        (s)
+typedef const char * PGM_P;
+#define strncpy_P   strncpy
+#define memcpy_P    memcpy
+#define strlen_P    strlen
+
+#if !defined(__GLIBC__) || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+inline size_t strlcpy(char * pcDst, const char * pcSrc, size_t uiSize) {
+    size_t len = strlen(pcSrc);
+    if (uiSize) {
+        size_t n = min(len, uiSize - 1);
+        memcpy(pcDst, pcSrc, n);
+        pcDst[n] = '\0';
+    }
+    return len;
+}
+#endif
+
+// ----------- Simulated clock -----------------
+inline uint64_t ullHostMicros = 0;
+
+inline void vHostAdvanceUs(uint64_t ullUs) { ullHostMicros += ullUs; }
+inline void vHostAdvanceMs(uint32_t ulMs) { ullHostMicros += (uint64_t)ulMs * 1000; }
+
+inline uint32_t micros() { return (uint32_t)ullHostMicros; }
+inline uint32_t millis() { return (uint32_t)(ullHostMicros / 1000); }
+inline void delay(uint32_t ulMs) { vHostAdvanceMs(ulMs); }
+inline void yield() {}
+
+// ----------- GPIO -----------------
+#define HOST_PINS   17
+
+inline uint8_t uiHostPinMode[HOST_PINS];
+inline uint8_t uiHostPinLevel[HOST_PINS] = { HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH, HIGH };
+inline uint32_t ulHostPinWrites = 0;
+
+inline volatile uint32_t GPO = 0;           // output register, GPIO0..15
+inline volatile uint32_t ulHostGpc[16];     // pin config registers
+#define GPC(p)  ulHostGpc[(p) & 0x0F]
+#define GPCI    7
+#define GPCWE   10
+
+inline uint32_t xt_rsil(uint32_t) { return 0; }
+inline void xt_wsr_ps(uint32_t) {}
+
+inline void pinMode(uint8_t uiPin, uint8_t uiMode) {
+    if (uiPin < HOST_PINS) uiHostPinMode[uiPin] = uiMode;
+}
+
+inline void digitalWrite(uint8_t uiPin, uint8_t uiLevel) {
+    if (uiPin >= HOST_PINS) return;
+    uiHostPinLevel[uiPin] = uiLevel;
+    if (uiPin < 16) GPO = uiLevel ? (GPO | (1UL << uiPin)) : (GPO & ~(1UL << uiPin));
+    ulHostPinWrites++;
+}
+
+// Outputs read back GPO, inputs whatever the test put into uiHostPinLevel
+inline int digitalRead(uint8_t uiPin) {
+    if (uiPin >= HOST_PINS) return LOW;
+    if (uiPin < 16 && uiHostPinMode[uiPin] == OUTPUT) return (GPO >> uiPin) & 1;
+    return uiHostPinLevel[uiPin];
+}
+
+#define digitalPinToInterrupt(p)    (p)
+inline void attachInterruptArg(uint8_t, void (*)(void *), void *, int) {}
+
+// ----------- String, IPAddress -----------------
+class String {
+public:
+    String() {}
+    String(const char * pc) : s(pc ? pc : "") {}
+    String(const std::string & str) : s(str) {}
+    const char * c_str() const { return s.c_str(); }
+    size_t length() const { return s.length(); }
+    String & operator=(const char * pc) { s = pc ? pc : ""; return *this; }
+    String operator+(const String & x) const { return String(s + x.s); }
+    String operator+(const char * pc) const { return String(s + pc); }
+    friend String operator+(const char * pc, const String & x) { return String(std::string(pc) + x.s); }
+private:
+    std::string s;
+};
+
+class IPAddress {
+public:
+    IPAddress() : ulAddr(0) {}
+    IPAddress(uint32_t ul) : ulAddr(ul) {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : ulAddr(a | (b << 8) | (c << 16) | ((uint32_t)d << 24)) {}
+    operator uint32_t() const { return ulAddr; }
+    String toString() const {
+        char pc[16];
+        snprintf(pc, sizeof(pc), "%u.%u.%u.%u", ulAddr & 0xFF, (ulAddr >> 8) & 0xFF, (ulAddr >> 16) & 0xFF, ulAddr >> 24);
+        return String(pc);
+    }
+private:
+    uint32_t ulAddr;
+};
+
+// ----------- Serial -----------------
+// Dropped unless bHostSerialEcho, ulHostSerialBytes counts what was written
+inline bool bHostSerialEcho = false;
+inline uint32_t ulHostSerialBytes = 0;
+
+class HardwareSerial {
+public:
+    void begin(uint32_t) {}
+    size_t write(const uint8_t * pc, size_t len) {
+        ulHostSerialBytes += len;
+        if (bHostSerialEcho) fwrite(pc, 1, len, stdout);
+        return len;
+    }
+    size_t print(const char * pc) { return write((const uint8_t *)pc, strlen(pc)); }
+    size_t print(const String & s) { return print(s.c_str()); }
+    size_t println(const char * pc = "") { return print(pc) + print("\n"); }
+    size_t println(const String & s) { return println(s.c_str()); }
+    size_t printf(const char * pcFmt, ...) __attribute__((format(printf, 2, 3))) {
+        char pc[256];
+        va_list xArgs;
+        va_start(xArgs, pcFmt);
+        vsnprintf(pc, sizeof(pc), pcFmt, xArgs);
+        va_end(xArgs);
+        return print(pc);
+    }
+    int availableForWrite() { return 128; }
+};
+
+inline HardwareSerial Serial;
+
+// ----------- ESP -----------------
+// Free heap is what the test says it is, the benchmark tracks operator new for it
+#define HOST_HEAP_SIZE      40960
+#define HOST_RTC_BYTES      512
+
+inline uint32_t ulHostHeapUsed = 0;
+inline uint8_t pcHostRtc[HOST_RTC_BYTES];
+inline bool bHostRestarted = false;
+
+class EspClass {
+public:
+    uint32_t getCycleCount() { return (uint32_t)(ullHostMicros * 80); }
+    uint8_t getCpuFreqMHz() { return 80; }
+    uint32_t getFreeHeap() { return HOST_HEAP_SIZE - ulHostHeapUsed; }
+    uint32_t getMaxFreeBlockSize() { return getFreeHeap(); }
+    uint8_t getHeapFragmentation() { return 0; }
+    uint32_t getChipId() { return 0x00C0FFEE; }
+    uint32_t random() { return xRng(); }
+    void restart() { bHostRestarted = true; }
+    bool rtcUserMemoryRead(uint32_t ulOffset, uint32_t * pulData, size_t uiSize) {
+        if (ulOffset * 4 + uiSize > HOST_RTC_BYTES) return false;
+        memcpy(pulData, pcHostRtc + ulOffset * 4, uiSize);
+        return true;
+    }
+    bool rtcUserMemoryWrite(uint32_t ulOffset, uint32_t * pulData, size_t uiSize) {
+        if (ulOffset * 4 + uiSize > HOST_RTC_BYTES) return false;
+        memcpy(pcHostRtc + ulOffset * 4, pulData, uiSize);
+        return true;
+    }
+private:
+    std::mt19937 xRng{ 12345 };
+};
+
+inline EspClass ESP;
+
+// ----------- SPI flash -----------------
+// HOST_FLASH_SIZE bytes of NOR flash: writes can only clear bits, erase sets a sector to 0xFF.
+// The filesystem area (_FS_start.._FS_end) is HOST_FS_SECTORS sectors at HOST_FS_OFFSET.
+#define SPI_FLASH_SEC_SIZE      4096
+#define HOST_FLASH_SIZE         0x10000
+#define HOST_FS_OFFSET          0x8000
+#define HOST_FS_SECTORS         2
+
+typedef enum {
+    SPI_FLASH_RESULT_OK = 0,
+    SPI_FLASH_RESULT_ERR,
+    SPI_FLASH_RESULT_TIMEOUT
+} SpiFlashOpResult;
+
+inline uint8_t pcHostFlash[HOST_FLASH_SIZE];
+inline bool bHostFlashInit = (memset(pcHostFlash, 0xFF, sizeof(pcHostFlash)), true);
+inline uint32_t ulHostFlashWrites = 0;
+inline uint32_t ulHostFlashErases = 0;
+
+inline SpiFlashOpResult spi_flash_read(uint32_t ulAddr, uint32_t * pulDst, uint32_t ulSize) {
+    if (ulAddr + ulSize > HOST_FLASH_SIZE) return SPI_FLASH_RESULT_ERR;
+    memcpy(pulDst, pcHostFlash + ulAddr, ulSize);
+    return SPI_FLASH_RESULT_OK;
+}
+
+inline SpiFlashOpResult spi_flash_write(uint32_t ulAddr, uint32_t * pulSrc, uint32_t ulSize) {
+    if ((ulAddr & 3) || (ulSize & 3) || ulAddr + ulSize > HOST_FLASH_SIZE) return SPI_FLASH_RESULT_ERR;
+    const uint8_t * pc = (const uint8_t *)pulSrc;
+    for (uint32_t i = 0; i < ulSize; i++) pcHostFlash[ulAddr + i] &= pc[i];
+    ulHostFlashWrites++;
+    return SPI_FLASH_RESULT_OK;
+}
+
+inline SpiFlashOpResult spi_flash_erase_sector(uint16_t uiSector) {
+    if ((uint32_t)(uiSector + 1) * SPI_FLASH_SEC_SIZE > HOST_FLASH_SIZE) return SPI_FLASH_RESULT_ERR;
+    memset(pcHostFlash + uiSector * SPI_FLASH_SEC_SIZE, 0xFF, SPI_FLASH_SEC_SIZE);
+    ulHostFlashErases++;
+    return SPI_FLASH_RESULT_OK;
+}
+
+// The firmware takes the linker symbols' addresses, flash is mapped at 0x40200000
+struct host_flash_symbol_t {
+    uintptr_t ulAddr;
+    uintptr_t operator&() const { return ulAddr; }
+};
+
+inline const host_flash_symbol_t _FS_start = { 0x40200000 + HOST_FS_OFFSET };
+inline const host_flash_symbol_t _FS_end = { 0x40200000 + HOST_FS_OFFSET + HOST_FS_SECTORS * SPI_FLASH_SEC_SIZE };
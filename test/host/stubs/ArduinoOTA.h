@@ -0,0 +1,31 @@
+#pragma once
+// Host stand-in for ArduinoOTA, no update ever comes in
+#include <Arduino.h>
+#include <functional>
+
+#define U_FLASH     0
+#define U_FS        100
+
+typedef enum {
+    OTA_AUTH_ERROR,
+    OTA_BEGIN_ERROR,
+    OTA_CONNECT_ERROR,
+    OTA_RECEIVE_ERROR,
+    OTA_END_ERROR
+} ota_error_t;
+
+class ArduinoOTAClass {
+public:
+    void setPassword(const char *) {}
+    void onStart(std::function<void()>) {}
+    void onEnd(std::function<void()>) {}
+    void onProgress(std::function<void(unsigned int, unsigned int)>) {}
+    void onError(std::function<void(ota_error_t)>) {}
+    void begin() { ulBegins++; }
+    void handle() {}
+    int getCommand() { return U_FLASH; }
+
+    uint32_t ulBegins = 0;
+};
+
+inline ArduinoOTAClass ArduinoOTA;
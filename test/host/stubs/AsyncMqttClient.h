@@ -0,0 +1,125 @@
+#pragma once
+// Host stand-in for AsyncMqttClient. connect() only records the attempt, the test plays the broker:
+// vHostConnect(), vHostDisconnect(), vHostMessage() and vHostAck() run the callbacks the way
+// the library does from SYS context. Publishes are counted and kept in xPublished unless bHostRecord
+// is cleared, so a benchmark sees no heap use of the stub itself.
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+
+enum class AsyncMqttClientDisconnectReason : uint8_t {
+    TCP_DISCONNECTED = 0,
+    MQTT_UNACCEPTABLE_PROTOCOL_VERSION = 1,
+    MQTT_IDENTIFIER_REJECTED = 2,
+    MQTT_SERVER_UNAVAILABLE = 3,
+    MQTT_MALFORMED_CREDENTIALS = 4,
+    MQTT_NOT_AUTHORIZED = 5
+};
+
+struct AsyncMqttClientMessageProperties {
+    uint8_t qos;
+    bool dup;
+    bool retain;
+};
+
+typedef struct {
+    std::string sTopic;
+    std::string sPayload;
+    uint8_t uiQos;
+    bool bRetain;
+    uint16_t uiPacketId;
+} host_mqtt_publish_t;
+
+class AsyncMqttClient {
+public:
+    typedef std::function<void(bool)> OnConnectUserCallback;
+    typedef std::function<void(AsyncMqttClientDisconnectReason)> OnDisconnectUserCallback;
+    typedef std::function<void(char *, char *, AsyncMqttClientMessageProperties, size_t, size_t, size_t)> OnMessageUserCallback;
+    typedef std::function<void(uint16_t)> OnPublishUserCallback;
+
+    AsyncMqttClient & onConnect(OnConnectUserCallback pvCB) { pvConnect = pvCB; return *this; }
+    AsyncMqttClient & onDisconnect(OnDisconnectUserCallback pvCB) { pvDisconnect = pvCB; return *this; }
+    AsyncMqttClient & onMessage(OnMessageUserCallback pvCB) { pvMessage = pvCB; return *this; }
+    AsyncMqttClient & onPublish(OnPublishUserCallback pvCB) { pvPublish = pvCB; return *this; }
+    AsyncMqttClient & setServer(const char *, uint16_t) { return *this; }
+    AsyncMqttClient & setCredentials(const char *, const char * = nullptr) { return *this; }
+    AsyncMqttClient & setClientId(const char *) { return *this; }
+    AsyncMqttClient & setCleanSession(bool b) { bCleanSession = b; return *this; }
+    AsyncMqttClient & setWill(const char *, uint8_t, bool, const char *, size_t = 0) { return *this; }
+
+    void connect() { ulConnects++; }
+    bool connected() const { return bConnected; }
+
+    uint16_t subscribe(const char * pcTopic, uint8_t) {
+        xSubscribed.push_back(pcTopic);
+        return uiNextPacketId();
+    }
+
+    // Packet id for QoS1, 1 for QoS0, 0 when the client has no room (bHostFull)
+    uint16_t publish(const char * pcTopic, uint8_t uiQos, bool bRetain, const char * pcPayload = nullptr, size_t len = 0, bool = false, uint16_t = 0) {
+        if (!bConnected || bHostFull) return 0;
+        if (pcPayload && len == 0) len = strlen(pcPayload);
+        uint16_t uiPacketId = uiQos ? uiNextPacketId() : 1;
+        ulPublishes++;
+        if (bHostRecord) xPublished.push_back({ pcTopic, std::string(pcPayload ? pcPayload : "", len), uiQos, bRetain, uiPacketId });
+        if (uiQos) xUnacked.push_back(uiPacketId);
+        return uiPacketId;
+    }
+
+    // Test side
+    void vHostConnect(bool bSessionPresent) {
+        bConnected = true;
+        if (pvConnect) pvConnect(bSessionPresent);
+    }
+    void vHostDisconnect() {
+        bConnected = false;
+        xUnacked.clear();
+        if (pvDisconnect) pvDisconnect(AsyncMqttClientDisconnectReason::TCP_DISCONNECTED);
+    }
+    // One message, in chunks of uiChunk bytes (0: one piece). Copied into the client's
+    // own buffers like the library does, the callback may not keep the pointers.
+    void vHostMessage(const char * pcTopic, const char * pcPayload, size_t len, size_t uiChunk = 0) {
+        AsyncMqttClientMessageProperties xProps = { 1, false, false };
+        strncpy(pcTopicBuf, pcTopic, sizeof(pcTopicBuf) - 1);
+        if (uiChunk == 0 || uiChunk > sizeof(pcChunkBuf)) uiChunk = sizeof(pcChunkBuf);
+        size_t uiIndex = 0;
+        do {
+            size_t uiLen = min(uiChunk, len - uiIndex);
+            memcpy(pcChunkBuf, pcPayload + uiIndex, uiLen);
+            pvMessage(pcTopicBuf, pcChunkBuf, xProps, uiLen, uiIndex, len);
+            uiIndex += uiLen;
+        } while (uiIndex < len);
+    }
+    // PUBACK for every QoS1 publish so far
+    void vHostAck() {
+        size_t n = xUnacked.size();
+        for (size_t i = 0; i < n; i++) {
+            if (pvPublish) pvPublish(xUnacked[i]);
+        }
+        xUnacked.erase(xUnacked.begin(), xUnacked.begin() + n);
+    }
+
+    std::vector<host_mqtt_publish_t> xPublished;
+    std::vector<std::string> xSubscribed;
+    std::vector<uint16_t> xUnacked;
+    uint32_t ulPublishes = 0;
+    uint32_t ulConnects = 0;
+    bool bCleanSession = true;
+    bool bHostFull = false;
+    bool bHostRecord = true;
+
+private:
+    uint16_t uiNextPacketId() {
+        if (++uiPacketId == 0) uiPacketId = 1;
+        return uiPacketId;
+    }
+
+    bool bConnected = false;
+    uint16_t uiPacketId = 0;
+    char pcTopicBuf[128] = {};
+    char pcChunkBuf[1460];      // one TCP segment
+    OnConnectUserCallback pvConnect;
+    OnDisconnectUserCallback pvDisconnect;
+    OnMessageUserCallback pvMessage;
+    OnPublishUserCallback pvPublish;
+};
@@ -0,0 +1,28 @@
+#pragma once
+// Host stand-in for the image signing part of BearSSLHelpers.h. The key is only looked at,
+// not parsed: any PEM public key header passes for RSA.
+#include <Updater.h>
+
+namespace BearSSL {
+
+class PublicKey {
+public:
+    PublicKey(const char * pcPem) : bRsa(strstr(pcPem, "-----BEGIN PUBLIC KEY-----") != NULL) {}
+    bool isRSA() const { return bRsa; }
+    bool isEC() const { return false; }
+
+private:
+    bool bRsa;
+};
+
+class HashSHA256 : public UpdaterHashClass {};
+
+class SigningVerifier : public UpdaterVerifyClass {
+public:
+    SigningVerifier(PublicKey * pxKey) : pxKey(pxKey) {}
+
+private:
+    PublicKey * pxKey;
+};
+
+}  // namespace BearSSL
@@ -0,0 +1,26 @@
+#pragma once
+// Host stand-in for the HTTPClient subset of ota_routine.h. There is no server: every GET fails
+// to connect, the OTA job retries and gives up like it does with the server down.
+#include <ESP8266WiFi.h>
+
+#define HTTP_CODE_OK                200
+#define HTTP_CODE_PARTIAL_CONTENT   206
+#define HTTPC_ERROR_CONNECTION_FAILED   (-1)
+
+class WiFiClient {
+public:
+    int available() { return 0; }
+    int read(uint8_t *, size_t) { return 0; }
+    uint8_t connected() { return 0; }
+};
+
+class HTTPClient {
+public:
+    bool begin(WiFiClient &, const String &) { return true; }
+    void setTimeout(uint16_t) {}
+    void addHeader(const String &, const String &) {}
+    int GET() { return HTTPC_ERROR_CONNECTION_FAILED; }
+    int getSize() { return -1; }
+    WiFiClient * getStreamPtr() { return nullptr; }
+    void end() {}
+};
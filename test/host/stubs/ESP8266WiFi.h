@@ -0,0 +1,90 @@
+#pragma once
+// Host stand-in for the station mode part of ESP8266WiFi.
+// begin() only records the attempt, the test decides its outcome with vHostGotIp()/vHostDisconnect().
+#include <Arduino.h>
+#include <functional>
+#include <memory>
+
+typedef enum {
+    WIFI_NONE_SLEEP = 0,
+    WIFI_LIGHT_SLEEP,
+    WIFI_MODEM_SLEEP
+} WiFiSleepType_t;
+
+struct WiFiEventStationModeGotIP {
+    IPAddress ip;
+    IPAddress mask;
+    IPAddress gw;
+};
+
+struct WiFiEventStationModeDisconnected {
+    String ssid;
+    uint8_t bssid[6];
+    int reason;
+};
+
+typedef std::shared_ptr<void> WiFiEventHandler;
+
+class ESP8266WiFiClass {
+public:
+    bool config(IPAddress xIp, IPAddress xGateway, IPAddress xMask, IPAddress xDns = IPAddress()) {
+        xStaticIp = xIp;
+        return true;
+    }
+    void begin(const char *, const char *, int32_t iChannel = 0, const uint8_t * pcBssid = nullptr) {
+        ulBegins++;
+        bFastBegin = pcBssid != nullptr;
+    }
+    // The SDK reports it later, from the test: vHostDisconnect()
+    bool disconnect() {
+        bConnected = false;
+        return true;
+    }
+    bool isConnected() { return bConnected; }
+    IPAddress localIP() { return bConnected ? IPAddress(192, 168, 1, 50) : IPAddress(); }
+    IPAddress subnetMask() { return IPAddress(255, 255, 255, 0); }
+    IPAddress gatewayIP() { return IPAddress(192, 168, 1, 1); }
+    IPAddress dnsIP(uint8_t = 0) { return IPAddress(192, 168, 1, 1); }
+    uint8_t * BSSID() { return pcBssid; }
+    int32_t channel() { return 6; }
+    void persistent(bool) {}
+    bool setAutoReconnect(bool) { return true; }
+    bool setSleepMode(WiFiSleepType_t xType, uint8_t = 0) {
+        xSleep = xType;
+        return true;
+    }
+    WiFiEventHandler onStationModeGotIP(std::function<void(const WiFiEventStationModeGotIP &)> pvCB) {
+        pvGotIp = pvCB;
+        return std::make_shared<int>(0);
+    }
+    WiFiEventHandler onStationModeDisconnected(std::function<void(const WiFiEventStationModeDisconnected &)> pvCB) {
+        pvDisconnected = pvCB;
+        return std::make_shared<int>(0);
+    }
+
+    // Test side
+    void vHostGotIp() {
+        bConnected = true;
+        WiFiEventStationModeGotIP xEvent = { localIP(), subnetMask(), gatewayIP() };
+        if (pvGotIp) pvGotIp(xEvent);
+    }
+    void vHostDisconnect(int iReason) {
+        bConnected = false;
+        WiFiEventStationModeDisconnected xEvent = {};
+        xEvent.reason = iReason;
+        if (pvDisconnected) pvDisconnected(xEvent);
+    }
+
+    uint32_t ulBegins = 0;
+    bool bFastBegin = false;
+    IPAddress xStaticIp;
+    WiFiSleepType_t xSleep = WIFI_NONE_SLEEP;
+
+private:
+    bool bConnected = false;
+    uint8_t pcBssid[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+    std::function<void(const WiFiEventStationModeGotIP &)> pvGotIp;
+    std::function<void(const WiFiEventStationModeDisconnected &)> pvDisconnected;
+};
+
+inline ESP8266WiFiClass WiFi;
@@ -0,0 +1,71 @@
+#pragma once
+// Host stand-in for the TimeLib subset the firmware uses. The clock follows the simulated millis().
+#include <Arduino.h>
+#include <time.h>
+
+#define SECS_PER_MIN    ((time_t)60UL)
+#define SECS_PER_HOUR   ((time_t)3600UL)
+#define SECS_PER_DAY    ((time_t)86400UL)
+
+#define elapsedSecsToday(t)     ((t) % SECS_PER_DAY)
+#define previousMidnight(t)     (((t) / SECS_PER_DAY) * SECS_PER_DAY)
+
+typedef enum {
+    timeNotSet = 0,
+    timeNeedsSync,
+    timeSet
+} timeStatus_t;
+
+typedef time_t (*getExternalTime)();
+
+inline time_t tHostTimeBase = 0;        // time at ulHostTimeSetMs
+inline uint32_t ulHostTimeSetMs = 0;
+inline timeStatus_t xHostTimeStatus = timeNotSet;
+inline getExternalTime pvHostSyncProvider = nullptr;
+
+inline void setTime(time_t t) {
+    tHostTimeBase = t;
+    ulHostTimeSetMs = millis();
+    xHostTimeStatus = timeSet;
+}
+
+// The provider is asked until it has an answer, real TimeLib asks again every 5 minutes
+inline time_t now() {
+    if (xHostTimeStatus == timeNotSet && pvHostSyncProvider) {
+        time_t t = pvHostSyncProvider();
+        if (t != 0) setTime(t);
+    }
+    return tHostTimeBase + (millis() - ulHostTimeSetMs) / 1000;
+}
+
+inline timeStatus_t timeStatus() {
+    now();
+    return xHostTimeStatus;
+}
+
+inline void setSyncProvider(getExternalTime pvProvider) { pvHostSyncProvider = pvProvider; }
+
+inline void configTime(int, int, const char *) {}
+
+inline struct tm xHostTm(time_t t) {
+    struct tm xTm;
+    gmtime_r(&t, &xTm);
+    return xTm;
+}
+
+inline int second(time_t t) { return xHostTm(t).tm_sec; }
+inline int minute(time_t t) { return xHostTm(t).tm_min; }
+inline int hour(time_t t) { return xHostTm(t).tm_hour; }
+inline int day(time_t t) { return xHostTm(t).tm_mday; }
+inline int month(time_t t) { return xHostTm(t).tm_mon + 1; }
+inline int year(time_t t) { return xHostTm(t).tm_year + 1900; }
+inline int weekday(time_t t) { return xHostTm(t).tm_wday + 1; }    // 1 = Sunday
+inline int second() { return second(now()); }
+inline int minute() { return minute(now()); }
+inline int hour() { return hour(now()); }
+inline int day() { return day(now()); }
+inline int month() { return month(now()); }
+inline int year() { return year(now()); }
+inline int weekday() { return weekday(now()); }
+
+#define dayOfWeek(t)    weekday(t)
@@ -0,0 +1,16 @@
+#pragma once
+// Host stand-in for the WiFiUDP subset of lan_control.h, nothing ever arrives
+#include <ESP8266WiFi.h>
+
+class WiFiUDP {
+public:
+    uint8_t begin(uint16_t) { return 1; }
+    int parsePacket() { return 0; }
+    int read(uint8_t *, size_t) { return 0; }
+    void flush() {}
+    IPAddress remoteIP() { return IPAddress(); }
+    uint16_t remotePort() { return 0; }
+    int beginPacket(IPAddress, uint16_t) { return 1; }
+    size_t write(const uint8_t *, size_t len) { return len; }
+    int endPacket() { return 1; }
+};
@@ -0,0 +1,12 @@
+#pragma once
+// Host stand-in: nothing to schedule, an idle slice just lets the simulated time run
+#include <Arduino.h>
+#include <functional>
+
+inline uint32_t ulHostSchedules = 0;
+
+inline void esp_schedule() { ulHostSchedules++; }
+
+inline void esp_delay(uint32_t ulMs, const std::function<bool()> & pvBlocked) {
+    if (pvBlocked()) vHostAdvanceMs(ulMs);
+}
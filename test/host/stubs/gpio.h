@@ -0,0 +1,8 @@
+#pragma once
+// Host stand-in for the SDK GPIO wakeup calls
+#include <stdint.h>
+
+#define GPIO_ID_PIN(n)          (n)
+#define GPIO_PIN_INTR_LOLEVEL   4
+
+inline void gpio_pin_wakeup_enable(uint32_t, int) {}
@@ -0,0 +1,149 @@
+#include <Arduino.h>
+#include <button_routine.h>
+#include <vector>
+#include "host_test.h"
+
+// One button on GPIO0, the test plays the contact: vLevel() sets the pin and fires the ISR,
+// vTicks() runs the handler once per millisecond like loop() does
+#define TEST_PIN    0
+
+typedef struct {
+    uint32_t ulAt;
+    button_gesture_t xGesture;
+} gesture_t;
+
+static std::vector<gesture_t> xGestures;
+static button_t xButton;
+
+static void vGestureCB(uint8_t uiButtonIdx, button_gesture_t xGesture) {
+    xGestures.push_back({ millis(), xGesture });
+}
+
+static void vStart(bool bDoubleEnabled) {
+    xGestures.clear();
+    uiHostPinLevel[TEST_PIN] = BUTTON_STATE_RELEASE;
+    memset(&xButton, 0, sizeof(xButton));
+    xButton.uiPin = TEST_PIN;
+    xButton.bDoubleEnabled = bDoubleEnabled;
+    vButtonsBegin(&xButton, 1);
+}
+
+static void vLevel(uint8_t uiLevel) {
+    uiHostPinLevel[TEST_PIN] = uiLevel;
+    vButtonISR(&xButton);
+}
+
+static void vTicks(uint32_t ulMs) {
+    for (uint32_t i = 0; i < ulMs; i++) {
+        vHostAdvanceMs(1);
+        if (bButtonsActive(&xButton, 1)) vButtonsHandler(&xButton, 1, vGestureCB);
+    }
+}
+
+static void vPress(uint32_t ulMs) {
+    vLevel(BUTTON_STATE_PUSH);
+    vTicks(ulMs);
+    vLevel(BUTTON_STATE_RELEASE);
+}
+
+TEST(single_fires_on_press_without_double) {
+    vStart(false);
+    uint32_t ulPressAt = millis();
+    vPress(60);
+    vTicks(BUTTON_DOUBLE_CLICK_MS * 2);
+    CHECK_EQ(xGestures.size(), 1);
+    CHECK_EQ(xGestures[0].xGesture, BTN_GESTURE_SINGLE);
+    CHECK_EQ(xGestures[0].ulAt - ulPressAt, BUTTON_DEBOUNCE_MS);
+    CHECK(!bButtonsActive(&xButton, 1));
+}
+
+TEST(single_waits_for_the_double_click_window) {
+    vStart(true);
+    vPress(60);
+    uint32_t ulReleaseAt = millis();
+    vTicks(BUTTON_DOUBLE_CLICK_MS - 1);
+    CHECK_EQ(xGestures.size(), 0);
+    vTicks(BUTTON_DOUBLE_CLICK_MS);
+    CHECK_EQ(xGestures.size(), 1);
+    CHECK_EQ(xGestures[0].xGesture, BTN_GESTURE_SINGLE);
+    CHECK_EQ(xGestures[0].ulAt - ulReleaseAt, BUTTON_DOUBLE_CLICK_MS);
+}
+
+TEST(double_click) {
+    vStart(true);
+    vPress(60);
+    vTicks(100);
+    vPress(60);
+    vTicks(BUTTON_DOUBLE_CLICK_MS * 2);
+    CHECK_EQ(xGestures.size(), 1);
+    CHECK_EQ(xGestures[0].xGesture, BTN_GESTURE_DOUBLE);
+}
+
+TEST(long_press_then_hold_repeats) {
+    vStart(true);
+    uint32_t ulPressAt = millis();
+    vPress(BUTTON_LONG_PRESS_MS + 2 * BUTTON_REPEAT_MS + 10);
+    vTicks(BUTTON_DOUBLE_CLICK_MS * 2);
+    CHECK_EQ(xGestures.size(), 3);
+    CHECK_EQ(xGestures[0].xGesture, BTN_GESTURE_LONG);
+    CHECK_EQ(xGestures[0].ulAt - ulPressAt, BUTTON_LONG_PRESS_MS);
+    CHECK_EQ(xGestures[1].xGesture, BTN_GESTURE_HOLD_REPEAT);
+    CHECK_EQ(xGestures[1].ulAt - xGestures[0].ulAt, BUTTON_REPEAT_MS);
+    CHECK_EQ(xGestures[2].xGesture, BTN_GESTURE_HOLD_REPEAT);
+    CHECK_EQ(xGestures[2].ulAt - xGestures[1].ulAt, BUTTON_REPEAT_MS);
+}
+
+// loop() was busy for the whole press: the press is still long, no single click
+TEST(long_press_seen_late) {
+    vStart(true);
+    vLevel(BUTTON_STATE_PUSH);
+    vHostAdvanceMs(BUTTON_LONG_PRESS_MS + 100);
+    vButtonsHandler(&xButton, 1, vGestureCB);     // picks up the press at its edge, already long
+    vLevel(BUTTON_STATE_RELEASE);
+    vTicks(BUTTON_DOUBLE_CLICK_MS * 2);
+    CHECK_EQ(xGestures.size(), 1);
+    CHECK_EQ(xGestures[0].xGesture, BTN_GESTURE_LONG);
+}
+
+TEST(bouncing_press_is_one_click) {
+    vStart(false);
+    for (int i = 0; i < 4; i++) {
+        vLevel(BUTTON_STATE_PUSH);
+        vTicks(1);
+        vLevel(BUTTON_STATE_RELEASE);
+        vTicks(1);
+    }
+    vLevel(BUTTON_STATE_PUSH);
+    vTicks(60);
+    for (int i = 0; i < 4; i++) {
+        vLevel(BUTTON_STATE_RELEASE);
+        vTicks(1);
+        vLevel(BUTTON_STATE_PUSH);
+        vTicks(1);
+    }
+    vLevel(BUTTON_STATE_RELEASE);
+    vTicks(BUTTON_DOUBLE_CLICK_MS * 2);
+    CHECK_EQ(xGestures.size(), 1);
+    CHECK_EQ(xGestures[0].xGesture, BTN_GESTURE_SINGLE);
+}
+
+// A glitch shorter than the debounce time that ends released is no press at all
+TEST(glitch_is_rejected) {
+    vStart(false);
+    vLevel(BUTTON_STATE_PUSH);
+    vTicks(BUTTON_DEBOUNCE_MS - 2);
+    vLevel(BUTTON_STATE_RELEASE);
+    vTicks(BUTTON_DOUBLE_CLICK_MS * 2);
+    CHECK_EQ(xGestures.size(), 0);
+    CHECK(!bButtonsActive(&xButton, 1));
+
+    vStart(true);
+    vPress(60);
+    vTicks(50);
+    vLevel(BUTTON_STATE_PUSH);      // a glitch inside the double click window
+    vTicks(1);
+    vLevel(BUTTON_STATE_RELEASE);
+    vTicks(BUTTON_DOUBLE_CLICK_MS * 2);
+    CHECK_EQ(xGestures.size(), 1);
+    CHECK_EQ(xGestures[0].xGesture, BTN_GESTURE_SINGLE);
+}
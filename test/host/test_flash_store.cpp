@@ -0,0 +1,203 @@
+#include <Arduino.h>
+#include <flash_store.h>
+#include "host_test.h"
+
+// The store runs on the RAM backed NOR flash of the Arduino.h stub, HOST_FS_SECTORS sectors at HOST_FS_OFFSET
+static flash_store_t xStore;
+
+static void vErase() {
+    memset(pcHostFlash, 0xFF, sizeof(pcHostFlash));
+}
+
+static uint32_t ulSector(uint8_t uiSector) {
+    return HOST_FS_OFFSET + uiSector * SPI_FLASH_SEC_SIZE;
+}
+
+static void vPut16(uint8_t uiKey, uint16_t uiValue) {
+    vFlashStorePut(&xStore, uiKey, &uiValue, sizeof(uiValue));
+}
+
+static uint16_t uiGet16(uint8_t uiKey) {
+    uint16_t uiValue = 0xDEAD;
+    if (!bFlashStoreGet(&xStore, uiKey, &uiValue, sizeof(uiValue))) return 0xDEAD;
+    return uiValue;
+}
+
+// A sector the way the store writes it: header, then one uint16_t record per entry
+static void vWriteSector(uint8_t uiSector, uint32_t ulGeneration, uint8_t uiKey, uint16_t uiValue) {
+    spi_flash_erase_sector(ulSector(uiSector) / SPI_FLASH_SEC_SIZE);
+    uint32_t pulRecord[2] = { uiKey | (uint32_t)sizeof(uiValue) << 8, 0xFFFFFFFF };
+    pulRecord[0] |= (uint32_t)uiFlashStoreCrc(pulRecord[0], &uiValue, sizeof(uiValue)) << 16;
+    memcpy(&pulRecord[1], &uiValue, sizeof(uiValue));
+    spi_flash_write(ulSector(uiSector) + FLASH_STORE_HEADER_LEN, pulRecord, sizeof(pulRecord));
+    uint32_t pulHeader[2] = { FLASH_STORE_MAGIC, ulGeneration };
+    spi_flash_write(ulSector(uiSector), pulHeader, sizeof(pulHeader));
+}
+
+TEST(blank_flash_starts_empty) {
+    vErase();
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(xStore.ulBase, HOST_FS_OFFSET);
+    CHECK_EQ(xStore.uiActive, 0);
+    CHECK_EQ(xStore.ulGeneration, 1);
+    CHECK_EQ(uiGet16(0), 0xDEAD);
+}
+
+TEST(values_survive_a_restart) {
+    vErase();
+    CHECK(bFlashStoreBegin(&xStore));
+    vPut16(0, 0x0005);
+    vPut16(1, 1234);
+    uint8_t pcBig[FLASH_STORE_VALUE_MAX];
+    for (size_t i = 0; i < sizeof(pcBig); i++) pcBig[i] = i;
+    vFlashStorePut(&xStore, 2, pcBig, sizeof(pcBig));
+    vFlashStoreFlush(&xStore);
+    CHECK_EQ(xStore.uiDirty, 0);
+    vPut16(0, 0x0006);
+    vFlashStoreFlush(&xStore);
+
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(uiGet16(0), 0x0006);
+    CHECK_EQ(uiGet16(1), 1234);
+    uint8_t pcOut[FLASH_STORE_VALUE_MAX] = {};
+    CHECK(bFlashStoreGet(&xStore, 2, pcOut, sizeof(pcOut)));
+    CHECK(memcmp(pcOut, pcBig, sizeof(pcBig)) == 0);
+    CHECK(!bFlashStoreGet(&xStore, 2, pcOut, 4));      // another size
+    CHECK_EQ(xStore.ulCompactions, 0);
+}
+
+TEST(writes_coalesce) {
+    vErase();
+    CHECK(bFlashStoreBegin(&xStore));
+    uint32_t ulWrites = ulHostFlashWrites;
+    for (uint16_t i = 0; i < 50; i++) {
+        vPut16(0, i);
+        vHostAdvanceMs(100);
+        vFlashStoreHandler(&xStore);
+    }
+    CHECK_EQ(ulHostFlashWrites, ulWrites);
+    vHostAdvanceMs(FLASH_STORE_COALESCE_MS);
+    vFlashStoreHandler(&xStore);
+    CHECK_EQ(ulHostFlashWrites, ulWrites + 1);
+    vPut16(0, 49);      // same value, nothing to write
+    CHECK_EQ(xStore.uiDirty, 0);
+}
+
+TEST(full_sector_is_compacted) {
+    vErase();
+    CHECK(bFlashStoreBegin(&xStore));
+    vPut16(1, 77);
+    for (uint16_t i = 0; i < 2000; i++) {
+        vPut16(0, i);
+        vFlashStoreFlush(&xStore);
+    }
+    CHECK(xStore.ulCompactions >= 2);
+    uint8_t uiActive = xStore.uiActive;
+    uint32_t ulGeneration = xStore.ulGeneration;
+
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(xStore.uiActive, uiActive);
+    CHECK_EQ(xStore.ulGeneration, ulGeneration);
+    CHECK_EQ(uiGet16(0), 1999);
+    CHECK_EQ(uiGet16(1), 77);
+}
+
+// Power lost in the middle of a record: the bits written so far fail the CRC
+TEST(torn_record_is_dropped) {
+    vErase();
+    CHECK(bFlashStoreBegin(&xStore));
+    vPut16(0, 0x00F0);
+    vPut16(1, 10);
+    vFlashStoreFlush(&xStore);
+    uint16_t uiTornAt = xStore.uiWriteOffset;
+    vPut16(1, 11);
+    vFlashStoreFlush(&xStore);
+    pcHostFlash[ulSector(0) + uiTornAt + 4] &= 0x00;     // the value was not fully written
+
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(uiGet16(0), 0x00F0);
+    CHECK_EQ(uiGet16(1), 10);           // the one before the torn record
+    CHECK_EQ(xStore.ulCompactions, 1);  // moved away from the torn tail right away
+    CHECK_EQ(xStore.uiActive, 1);
+    vPut16(1, 12);
+    vFlashStoreFlush(&xStore);
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(uiGet16(1), 12);
+    CHECK_EQ(uiGet16(0), 0x00F0);
+}
+
+// Power lost after the record header went out but before the value
+TEST(torn_header_is_dropped) {
+    vErase();
+    CHECK(bFlashStoreBegin(&xStore));
+    vPut16(0, 3);
+    vFlashStoreFlush(&xStore);
+    uint32_t ulHeader = 1 | (uint32_t)sizeof(uint16_t) << 8;     // key 1, the CRC still 0
+    spi_flash_write(ulSector(0) + xStore.uiWriteOffset, &ulHeader, sizeof(ulHeader));
+
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(uiGet16(0), 3);
+    CHECK_EQ(uiGet16(1), 0xDEAD);
+    CHECK_EQ(xStore.ulCompactions, 1);
+}
+
+// A compaction cut before its header: the other sector is still in charge
+TEST(interrupted_compaction_keeps_the_old_sector) {
+    vErase();
+    vWriteSector(0, 7, 0, 100);
+    spi_flash_erase_sector(ulSector(1) / SPI_FLASH_SEC_SIZE);
+    uint32_t pulRecord[2] = { 0 | 2 << 8, 0xFFFF0000 | 200 };     // a record, no header yet
+    spi_flash_write(ulSector(1) + FLASH_STORE_HEADER_LEN, pulRecord, sizeof(pulRecord));
+
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(xStore.uiActive, 0);
+    CHECK_EQ(xStore.ulGeneration, 7);
+    CHECK_EQ(uiGet16(0), 100);
+}
+
+TEST(newest_generation_wins) {
+    vErase();
+    vWriteSector(0, 7, 0, 100);
+    vWriteSector(1, 8, 0, 200);
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(xStore.uiActive, 1);
+    CHECK_EQ(uiGet16(0), 200);
+
+    vErase();
+    vWriteSector(0, 9, 0, 100);
+    vWriteSector(1, 8, 0, 200);
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(xStore.uiActive, 0);
+    CHECK_EQ(uiGet16(0), 100);
+}
+
+// The generation counter wrapped: 0 comes after 0xFFFFFFFF
+TEST(generation_wraps) {
+    vErase();
+    vWriteSector(0, 0xFFFFFFFF, 0, 100);
+    vWriteSector(1, 0, 0, 200);
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(xStore.uiActive, 1);
+    CHECK_EQ(xStore.ulGeneration, 0);
+    CHECK_EQ(uiGet16(0), 200);
+
+    vErase();
+    vWriteSector(0, 0xFFFFFFFE, 0, 100);
+    vWriteSector(1, 0xFFFFFFFF, 0, 200);
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(xStore.uiActive, 1);
+    CHECK(bFlashStoreCompact(&xStore));     // 0xFFFFFFFF + 1
+    CHECK_EQ(xStore.uiActive, 0);
+    CHECK_EQ(xStore.ulGeneration, 0);
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(xStore.uiActive, 0);
+    CHECK_EQ(uiGet16(0), 200);
+}
+
+TEST(only_one_valid_sector) {
+    vErase();
+    vWriteSector(1, 3, 0, 300);
+    CHECK(bFlashStoreBegin(&xStore));
+    CHECK_EQ(xStore.uiActive, 1);
+    CHECK_EQ(uiGet16(0), 300);
+}
@@ -0,0 +1,50 @@
+#include <Arduino.h>
+#include <group_control.h>
+#include "host_test.h"
+
+TEST(by_bitmap) {
+    // Devices 0 and 9 of a 2 byte bitmap, 3 channels: ON, none, TOGGLE
+    const uint8_t pcFrame[] = { GROUP_FRAME_COMMAND, 0, 2, 0, 0x01, 0x02, 3, 0x31 };
+    group_command_t xCmd;
+    CHECK(bGroupDecode(pcFrame, sizeof(pcFrame), 0, 0, &xCmd));
+    CHECK(bGroupDecode(pcFrame, sizeof(pcFrame), 9, 0, &xCmd));
+    CHECK(!bGroupDecode(pcFrame, sizeof(pcFrame), 1, 0, &xCmd));
+    CHECK(!bGroupDecode(pcFrame, sizeof(pcFrame), 16, 0, &xCmd));  // past the bitmap
+    CHECK_EQ(xCmd.uiChannels, 3);
+    CHECK_EQ(uiGroupOp(&xCmd, 0), GROUP_OP_ON);
+    CHECK_EQ(uiGroupOp(&xCmd, 1), GROUP_OP_NONE);
+    CHECK_EQ(uiGroupOp(&xCmd, 2), GROUP_OP_TOGGLE);
+    CHECK_EQ(uiGroupOp(&xCmd, 3), GROUP_OP_NONE);    // not in the frame
+}
+
+TEST(by_group_id) {
+    const uint8_t pcFrame[] = { GROUP_FRAME_COMMAND, GROUP_FLAG_BY_ID, 5, 0, 5, 0xAA, 0x02 };
+    group_command_t xCmd;
+    CHECK(bGroupDecode(pcFrame, sizeof(pcFrame), 0, 1UL << 5, &xCmd));
+    CHECK(!bGroupDecode(pcFrame, sizeof(pcFrame), 0, (uint32_t)~(1UL << 5), &xCmd));
+    CHECK_EQ(xCmd.uiChannels, 5);
+    for (uint8_t i = 0; i < 4; i++) CHECK_EQ(uiGroupOp(&xCmd, i), GROUP_OP_OFF);
+    CHECK_EQ(uiGroupOp(&xCmd, 4), GROUP_OP_OFF);
+    const uint8_t pcFar[] = { GROUP_FRAME_COMMAND, GROUP_FLAG_BY_ID, 32, 0, 1, 0x01 };
+    CHECK(!bGroupDecode(pcFar, sizeof(pcFar), 0, 0xFFFFFFFFUL, &xCmd));    // IDs are 0..31
+}
+
+TEST(truncated_frames) {
+    group_command_t xCmd;
+    const uint8_t pcNoOps[] = { GROUP_FRAME_COMMAND, GROUP_FLAG_BY_ID, 0, 0, 5, 0x55 };   // 5 channels need 2 bytes
+    CHECK(!bGroupDecode(pcNoOps, sizeof(pcNoOps), 0, 1, &xCmd));
+    const uint8_t pcShortMap[] = { GROUP_FRAME_COMMAND, 0, 4, 0, 0xFF, 0xFF };
+    CHECK(!bGroupDecode(pcShortMap, sizeof(pcShortMap), 0, 0, &xCmd));
+    const uint8_t pcTiny[] = { GROUP_FRAME_COMMAND, 0, 0, 0 };
+    CHECK(!bGroupDecode(pcTiny, sizeof(pcTiny), 0, 0, &xCmd));
+    const uint8_t pcWrongType[] = { 0x01, GROUP_FLAG_BY_ID, 0, 0, 1, 0x01 };
+    CHECK(!bGroupDecode(pcWrongType, sizeof(pcWrongType), 0, 1, &xCmd));
+}
+
+TEST(no_channels) {
+    const uint8_t pcFrame[] = { GROUP_FRAME_COMMAND, GROUP_FLAG_BY_ID, 0, 0, 0 };
+    group_command_t xCmd;
+    CHECK(bGroupDecode(pcFrame, sizeof(pcFrame), 0, 1, &xCmd));
+    CHECK_EQ(xCmd.uiChannels, 0);
+    CHECK_EQ(uiGroupOp(&xCmd, 0), GROUP_OP_NONE);
+}
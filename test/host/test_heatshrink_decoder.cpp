@@ -0,0 +1,85 @@
+#include <Arduino.h>
+#include <heatshrink_decoder.h>
+#include <vector>
+#include "host_test.h"
+#include "fixtures/heatshrink_image.h"
+
+// Collects the output, refuses once it has ulLimit bytes
+typedef struct {
+    std::vector<uint8_t> xOut;
+    uint32_t ulLimit;
+    uint32_t ulCalls;
+} sink_t;
+
+static bool bSink(const uint8_t * pcData, size_t len, void * pvCtx) {
+    sink_t * pxSink = (sink_t *)pvCtx;
+    pxSink->ulCalls++;
+    if (len > HS_WINDOW_SIZE || pxSink->xOut.size() + len > pxSink->ulLimit) return false;
+    pxSink->xOut.insert(pxSink->xOut.end(), pcData, pcData + len);
+    return true;
+}
+
+// Feeds pcIn in pieces of 1..uiMaxChunk bytes, 0: all at once
+static bool bDecode(const uint8_t * pcIn, size_t len, size_t uiMaxChunk, sink_t * pxSink, std::mt19937 * pxRng = NULL) {
+    static hs_decoder_t xDec;
+    vHsBegin(&xDec);
+    size_t i = 0;
+    while (i < len) {
+        size_t n = len - i;
+        if (uiMaxChunk) n = min(n, pxRng ? 1 + (*pxRng)() % uiMaxChunk : uiMaxChunk);
+        if (!bHsFeed(&xDec, pcIn + i, n, bSink, pxSink)) return false;
+        i += n;
+    }
+    return xDec.ulOut == pxSink->xOut.size();
+}
+
+static bool bIsImage(const sink_t * pxSink) {
+    return pxSink->xOut.size() == sizeof(pcHsImage) && memcmp(pxSink->xOut.data(), pcHsImage, sizeof(pcHsImage)) == 0;
+}
+
+// Worked out by hand: literal 'a', then index 0 (1 back) count 2 (3 bytes), zero padding
+TEST(hand_encoded_backref) {
+    const uint8_t pcIn[] = { 0xB0, 0x80, 0x01, 0x00 };
+    sink_t xSink = { {}, 1024, 0 };
+    CHECK(bDecode(pcIn, sizeof(pcIn), 0, &xSink));
+    CHECK_EQ(xSink.xOut.size(), 4);
+    CHECK(memcmp(xSink.xOut.data(), "aaaa", 4) == 0);
+}
+
+// The long image is encoded by fixtures/hs_encode.py, not by upstream heatshrink: these check the
+// decoder state carried across feeds and the window wrap, test_heatshrink_vectors.cpp the format
+TEST(long_image_in_one_piece) {
+    sink_t xSink = { {}, sizeof(pcHsImage), 0 };
+    CHECK(sizeof(pcHsImage) > 2 * HS_WINDOW_SIZE);
+    CHECK(bDecode(pcHsImageEncoded, sizeof(pcHsImageEncoded), 0, &xSink));
+    CHECK(bIsImage(&xSink));
+}
+
+TEST(long_image_byte_by_byte) {
+    sink_t xSink = { {}, sizeof(pcHsImage), 0 };
+    CHECK(bDecode(pcHsImageEncoded, sizeof(pcHsImageEncoded), 1, &xSink));
+    CHECK(bIsImage(&xSink));
+}
+
+// Chunks of 1..uiMax bytes, the way OTA hands over TCP segments
+TEST(long_image_random_chunks) {
+    std::mt19937 xRng(1);
+    for (size_t uiMax : { 2, 7, 64, 536, 1460 }) {
+        for (int n = 0; n < 20; n++) {
+            sink_t xSink = { {}, sizeof(pcHsImage), 0 };
+            CHECK(bDecode(pcHsImageEncoded, sizeof(pcHsImageEncoded), uiMax, &xSink, &xRng));
+            CHECK(bIsImage(&xSink));
+        }
+    }
+}
+
+TEST(refusing_sink_stops_decoding) {
+    sink_t xSink = { {}, HS_WINDOW_SIZE, 0 };
+    CHECK(!bDecode(pcHsImageEncoded, sizeof(pcHsImageEncoded), 0, &xSink));
+    CHECK(xSink.xOut.size() <= HS_WINDOW_SIZE);
+    CHECK(memcmp(xSink.xOut.data(), pcHsImage, xSink.xOut.size()) == 0);
+    uint32_t ulCalls = xSink.ulCalls;
+    xSink.ulLimit = 0;
+    CHECK(!bDecode(pcHsImageEncoded, sizeof(pcHsImageEncoded), 16, &xSink));
+    CHECK_EQ(xSink.ulCalls, ulCalls + 1);       // first refusal ends it
+}
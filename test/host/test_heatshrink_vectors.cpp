@@ -0,0 +1,49 @@
+#include <Arduino.h>
+#include <heatshrink_decoder.h>
+#include <vector>
+#include "host_test.h"
+
+// Expected outputs of the upstream heatshrink encoder tests (test_heatshrink_dynamic.c), decoded
+// back to their inputs. Built once per window/lookahead pair they were encoded with, see CMakeLists.txt.
+//   encoder_should_emit_data_without_repetitions_as_literal_sequence   -w 8 -l 7
+//   encoder_should_emit_series_of_same_byte_as_literal_then_backref    -w 8 -l 7
+//   encoder_poll_should_detect_repeated_substring                      -w 8 -l 3
+
+typedef struct {
+    const char * pcName;
+    std::vector<uint8_t> xEncoded;
+    std::vector<uint8_t> xDecoded;
+} hs_vector_t;
+
+static const hs_vector_t xVectors[] = {
+#if HS_WINDOW_BITS == 8 && HS_LOOKAHEAD_BITS == 7
+    { "literal_sequence", { 0x80, 0x40, 0x60, 0x50, 0x38, 0x20 }, { 0, 1, 2, 3, 4 } },
+    { "literal_then_backref", { 0xB0, 0x80, 0x01, 0x80 }, { 'a', 'a', 'a', 'a', 'a' } },
+#elif HS_WINDOW_BITS == 8 && HS_LOOKAHEAD_BITS == 3
+    { "repeated_substring", { 0xB0, 0xD8, 0xAC, 0x76, 0x40, 0x1B }, { 'a', 'b', 'c', 'd', 'a', 'b', 'c', 'd' } },
+#else
+#error "no upstream vectors for this HS_WINDOW_BITS/HS_LOOKAHEAD_BITS"
+#endif
+};
+
+static bool bSink(const uint8_t * pcData, size_t len, void * pvCtx) {
+    std::vector<uint8_t> * pxOut = (std::vector<uint8_t> *)pvCtx;
+    pxOut->insert(pxOut->end(), pcData, pcData + len);
+    return true;
+}
+
+// In one piece and byte by byte
+TEST(upstream_vectors) {
+    for (const hs_vector_t & xVector : xVectors) {
+        for (size_t uiChunk : { xVector.xEncoded.size(), (size_t)1 }) {
+            static hs_decoder_t xDec;
+            std::vector<uint8_t> xOut;
+            vHsBegin(&xDec);
+            for (size_t i = 0; i < xVector.xEncoded.size(); i += uiChunk) {
+                CHECK(bHsFeed(&xDec, xVector.xEncoded.data() + i, min(uiChunk, xVector.xEncoded.size() - i), bSink, &xOut));
+            }
+            if (xOut != xVector.xDecoded) printf("%s in chunks of %u:\n", xVector.pcName, (unsigned)uiChunk);
+            CHECK(xOut == xVector.xDecoded);
+        }
+    }
+}
@@ -0,0 +1,124 @@
+#include <Arduino.h>
+#include <json_parser.h>
+#include "host_test.h"
+
+// Walks the whole object, false on a syntax error
+static bool bMembers(const char * pc, json_token_t * pxKeys, json_token_t * pxValues, int * piCount) {
+    json_cursor_t xCur;
+    *piCount = 0;
+    if (!bJsonBegin(&xCur, pc, strlen(pc))) return false;
+    while (bJsonNextMember(&xCur, &pxKeys[*piCount], &pxValues[*piCount])) (*piCount)++;
+    return !xCur.bError;
+}
+
+TEST(members_and_types) {
+    json_token_t xKeys[8], xValues[8];
+    int iCount;
+    CHECK(bMembers(" { \"l1_state\" : \"ON\", \"n\":-12, \"b\":true, \"z\":null, \"o\":{\"a\":[1,\"}\"]}, \"a\":[1,2] } ", xKeys, xValues, &iCount));
+    CHECK_EQ(iCount, 6);
+    CHECK(bJsonTokenEq(&xKeys[0], "l1_state"));
+    CHECK(bJsonTokenEq(&xValues[0], "ON"));
+    CHECK_EQ(xValues[0].xType, JSON_TYPE_STRING);
+    CHECK(bJsonTokenEq(&xValues[1], "-12"));
+    CHECK_EQ(xValues[1].xType, JSON_TYPE_NUMBER);
+    CHECK_EQ(xValues[2].xType, JSON_TYPE_BOOL);
+    CHECK_EQ(xValues[3].xType, JSON_TYPE_NULL);
+    CHECK_EQ(xValues[4].xType, JSON_TYPE_OBJECT);
+    CHECK(bJsonTokenEq(&xValues[4], "{\"a\":[1,\"}\"]}"));
+    CHECK_EQ(xValues[5].xType, JSON_TYPE_ARRAY);
+    CHECK(bJsonTokenEq(&xValues[5], "[1,2]"));
+}
+
+TEST(escapes_stay_in_place) {
+    json_token_t xKeys[2], xValues[2];
+    int iCount;
+    CHECK(bMembers("{\"k\":\"a\\\"b\"}", xKeys, xValues, &iCount));
+    CHECK_EQ(iCount, 1);
+    CHECK(bJsonTokenEq(&xValues[0], "a\\\"b"));
+}
+
+TEST(empty_object) {
+    json_token_t xKeys[1], xValues[1];
+    int iCount;
+    CHECK(bMembers("{}", xKeys, xValues, &iCount));
+    CHECK_EQ(iCount, 0);
+}
+
+TEST(not_an_object) {
+    json_cursor_t xCur;
+    CHECK(!bJsonBegin(&xCur, "[1]", 3));
+    CHECK(xCur.bError);
+    CHECK(!bJsonBegin(&xCur, "   ", 3));
+}
+
+TEST(syntax_errors) {
+    json_token_t xKeys[4], xValues[4];
+    int iCount;
+    CHECK(!bMembers("{\"a\":\"ON\"", xKeys, xValues, &iCount));        // no closing brace
+    CHECK(!bMembers("{\"a\" \"ON\"}", xKeys, xValues, &iCount));       // no colon
+    CHECK(!bMembers("{\"a\":}", xKeys, xValues, &iCount));             // no value
+    CHECK(!bMembers("{\"a\":\"ON}", xKeys, xValues, &iCount));         // open string
+    CHECK(!bMembers("{\"a\":xyz}", xKeys, xValues, &iCount));          // bad literal
+    CHECK(!bMembers("{a:1}", xKeys, xValues, &iCount));                // unquoted key
+    CHECK(!bMembers("{\"a\":[1,2}", xKeys, xValues, &iCount));         // open array
+}
+
+TEST(members_need_one_comma_between) {
+    json_token_t xKeys[4], xValues[4];
+    int iCount;
+    CHECK(!bMembers("{\"a\":1 \"b\":2}", xKeys, xValues, &iCount));     // missing comma
+    CHECK(!bMembers("{\"a\":\"x\"\"b\":2}", xKeys, xValues, &iCount)); // missing comma after a string
+    CHECK(!bMembers("{,\"a\":1}", xKeys, xValues, &iCount));          // leading comma
+    CHECK(!bMembers("{\"a\":1,}", xKeys, xValues, &iCount));          // trailing comma
+    CHECK(!bMembers("{\"a\":1,,\"b\":2}", xKeys, xValues, &iCount));  // double comma
+    CHECK(!bMembers("{,}", xKeys, xValues, &iCount));
+    CHECK(bMembers("{ \"a\" : 1 , \"b\" : 2 }", xKeys, xValues, &iCount));
+    CHECK_EQ(iCount, 2);
+}
+
+TEST(length_bound_is_respected) {
+    // Only the first len bytes are looked at, the payload is not NUL terminated on the device
+    const char pc[] = "{\"a\":1}garbage";
+    json_cursor_t xCur;
+    json_token_t xKey, xValue;
+    CHECK(bJsonBegin(&xCur, pc, 7));
+    CHECK(bJsonNextMember(&xCur, &xKey, &xValue));
+    CHECK(bJsonTokenEq(&xValue, "1"));
+    CHECK(!bJsonNextMember(&xCur, &xKey, &xValue));
+    CHECK(!xCur.bError);
+    CHECK(bJsonBegin(&xCur, pc, 6));    // cut before '}'
+    CHECK(bJsonNextMember(&xCur, &xKey, &xValue));
+    CHECK(!bJsonNextMember(&xCur, &xKey, &xValue));
+    CHECK(xCur.bError);
+}
+
+TEST(token_eq) {
+    json_token_t xTok = { "ONE", 2, JSON_TYPE_STRING };
+    CHECK(bJsonTokenEq(&xTok, "ON"));
+    CHECK(!bJsonTokenEq(&xTok, "ONE"));
+    CHECK(!bJsonTokenEq(&xTok, "O"));
+}
+
+TEST(token_to_uint) {
+    uint32_t ul = 7;
+    json_token_t xTok = { "3600", 4, JSON_TYPE_NUMBER };
+    CHECK(bJsonTokenToUInt(&xTok, 65535, &ul));
+    CHECK_EQ(ul, 3600);
+    xTok = { "65535", 5, JSON_TYPE_NUMBER };
+    CHECK(bJsonTokenToUInt(&xTok, 65535, &ul));
+    CHECK_EQ(ul, 65535);
+    xTok = { "4294967295", 10, JSON_TYPE_NUMBER };
+    CHECK(bJsonTokenToUInt(&xTok, UINT32_MAX, &ul));
+    CHECK_EQ(ul, 4294967295UL);
+    ul = 7;
+    const char * pcBad[] = { "-5", "65536", "99999999999", "1.5", "1e3", "+1", "" };
+    for (const char * pc : pcBad) {
+        xTok = { pc, (uint16_t)strlen(pc), JSON_TYPE_NUMBER };
+        CHECK(!bJsonTokenToUInt(&xTok, 65535, &ul));
+    }
+    xTok = { "5", 1, JSON_TYPE_NUMBER };
+    CHECK(!bJsonTokenToUInt(&xTok, 4, &ul));
+    xTok = { "12", 2, JSON_TYPE_STRING };
+    CHECK(!bJsonTokenToUInt(&xTok, 65535, &ul));
+    CHECK_EQ(ul, 7);        // untouched on failure
+}
@@ -0,0 +1,61 @@
+#include <Arduino.h>
+#include <lan_control.h>
+#include "host_test.h"
+
+static lan_control_t xNew() {
+    lan_control_t xLan;
+    memset(&xLan, 0, sizeof(xLan));
+    return xLan;
+}
+
+TEST(each_counter_once) {
+    lan_control_t xLan = xNew();
+    CHECK(bLanReplayCheck(&xLan, 1000));
+    CHECK(!bLanReplayCheck(&xLan, 1000));
+    CHECK(bLanReplayCheck(&xLan, 1001));
+    CHECK(!bLanReplayCheck(&xLan, 1001));
+    CHECK(!bLanReplayCheck(&xLan, 1000));
+}
+
+TEST(out_of_order_inside_the_window) {
+    lan_control_t xLan = xNew();
+    CHECK(bLanReplayCheck(&xLan, 100));
+    CHECK(bLanReplayCheck(&xLan, 90));
+    CHECK(bLanReplayCheck(&xLan, 99));
+    CHECK(!bLanReplayCheck(&xLan, 90));
+    CHECK(bLanReplayCheck(&xLan, 100 - (LAN_REPLAY_WINDOW - 1)));
+    CHECK(!bLanReplayCheck(&xLan, 100 - LAN_REPLAY_WINDOW));        // fell out
+    CHECK(!bLanReplayCheck(&xLan, 5));
+}
+
+TEST(window_slides) {
+    lan_control_t xLan = xNew();
+    CHECK(bLanReplayCheck(&xLan, 10));
+    CHECK(bLanReplayCheck(&xLan, 12));
+    CHECK(bLanReplayCheck(&xLan, 40));      // 10 is now 30 back, 12 is 28 back
+    CHECK(!bLanReplayCheck(&xLan, 12));
+    CHECK(bLanReplayCheck(&xLan, 11));
+    CHECK(bLanReplayCheck(&xLan, 45));      // 11 is now 34 back
+    CHECK(!bLanReplayCheck(&xLan, 11));
+    CHECK(!bLanReplayCheck(&xLan, 40));
+    CHECK(bLanReplayCheck(&xLan, 1000));    // big jump clears the window
+    CHECK(!bLanReplayCheck(&xLan, 45));
+    CHECK(bLanReplayCheck(&xLan, 999));
+}
+
+TEST(counter_wraps) {
+    lan_control_t xLan = xNew();
+    CHECK(bLanReplayCheck(&xLan, 0xFFFFFFFEUL));
+    CHECK(bLanReplayCheck(&xLan, 2));       // newer across the wrap
+    CHECK(!bLanReplayCheck(&xLan, 0xFFFFFFFEUL));
+    CHECK(bLanReplayCheck(&xLan, 0xFFFFFFFFUL));
+    CHECK(bLanReplayCheck(&xLan, 0));
+    CHECK(!bLanReplayCheck(&xLan, 2));
+}
+
+TEST(first_counter_may_be_anything) {
+    lan_control_t xLan = xNew();
+    CHECK(bLanReplayCheck(&xLan, 0));
+    CHECK(!bLanReplayCheck(&xLan, 0));
+    CHECK(bLanReplayCheck(&xLan, 1));
+}
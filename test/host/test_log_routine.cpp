@@ -0,0 +1,101 @@
+#include <Arduino.h>
+#include <log_routine.h>
+#include <string>
+#include "host_test.h"
+
+// Pushes one record like LOG_* does and formats it back
+template <typename... A>
+static std::string sLog(const char * pcFmt, A... xArgs) {
+    vLogPush(LOG_LEVEL_INFO, pcFmt, xArgs...);
+    log_record_t xRec;
+    if (!bQueuePop(&xLogRing, &xRec)) return "<none>";
+    char pcLine[LOG_LINE_LEN + 1];
+    uiLogFormat(&xRec, pcLine, sizeof(pcLine));
+    return pcLine;
+}
+
+// What snprintf makes of it at the call
+template <typename... A>
+static std::string sExpect(const char * pcFmt, A... xArgs) {
+    char pcLine[LOG_LINE_LEN + 1];
+    int iLen = snprintf(pcLine, sizeof(pcLine), "%u I ", (unsigned)millis());
+    snprintf(pcLine + iLen, sizeof(pcLine) - iLen, pcFmt, xArgs...);
+    return pcLine;
+}
+
+#define CHECK_LOG(fmt, ...)     CHECK_EQ_STR(sLog(fmt, ##__VA_ARGS__), sExpect(fmt, ##__VA_ARGS__))
+#define CHECK_EQ_STR(a, b) do { \
+        std::string sA = (a), sB = (b); \
+        if (sA != sB) { \
+            printf("%s:%d: \"%s\" != \"%s\"\n", __FILE__, __LINE__, sA.c_str(), sB.c_str()); \
+            iHostFailures++; \
+        } \
+    } while (0)
+
+TEST(integers) {
+    vHostAdvanceMs(1234);
+    CHECK_LOG("plain text");
+    CHECK_LOG("%d %i %u", -5, 42, 4000000000U);
+    CHECK_LOG("%x %X %o %#x", 0xBEEFU, 0xBEEFU, 8U, 255U);
+    CHECK_LOG("[%5d|%-5d|%05d|%+d]", 12, 12, 12, 12);
+    CHECK_LOG("%c%c%c", 'a', 'b', 'c');
+    CHECK_LOG("100%% of %d", 3);
+    CHECK_LOG("%hhu %hu %zu", (unsigned)200, (unsigned)60000, (size_t)7);
+}
+
+TEST(wide_integers) {
+    CHECK_LOG("%lld %llu", (long long)-9223372036854775807LL, (unsigned long long)18446744073709551615ULL);
+    CHECK_LOG("%d %lld %d", 1, (long long)1 << 40, 2);       // a 64 bit value between 32 bit ones
+    int64_t iPing = 1700000000123LL;
+    CHECK_LOG("Payload: %lld", (long long)iPing);
+}
+
+TEST(strings) {
+    CHECK_LOG("%s and %s", "one", "two");
+    CHECK_LOG("[%8s|%-8s|%.2s]", "ab", "ab", "abcdef");
+    CHECK_LOG("%.*s!", 3, "abcdef");
+    CHECK_LOG("%*d", 6, 42);
+    const char * pcNull = NULL;
+    CHECK_EQ_STR(sLog("%s", pcNull), sExpect("%s", "(null)"));
+    char pcMutable[] = "mutable";
+    CHECK_LOG("%s", pcMutable);
+}
+
+// All strings of a record share LOG_STR_LEN bytes, the ones that do not fit are cut
+TEST(long_strings_are_cut) {
+    std::string sLong(LOG_STR_LEN * 2, 'x');
+    std::string sCut(LOG_STR_LEN - 1, 'x');
+    CHECK_EQ_STR(sLog("<%s>", sLong.c_str()), sExpect("<%s>", sCut.c_str()));
+    std::string sHalf(LOG_STR_LEN / 2, 'y');
+    std::string sRest(LOG_STR_LEN - 1 - (LOG_STR_LEN / 2 + 1), 'z');
+    CHECK_EQ_STR(sLog("%s %s %s", sHalf.c_str(), sLong.c_str(), "gone"), sExpect("%s %s %s", sHalf.c_str(), (std::string(sRest.size(), 'x')).c_str(), ""));
+}
+
+TEST(missing_and_extra_args) {
+    CHECK_EQ_STR(sLog("%d %d"), sExpect("%d %d", 0, 0));
+    CHECK_EQ_STR(sLog("%d", 1, 2, 3), sExpect("%d", 1));
+    // more than LOG_MAX_ARGS words: the rest reads as 0
+    CHECK_EQ_STR(sLog("%d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9), sExpect("%d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 0));
+}
+
+TEST(line_is_bounded) {
+    vLogPush(LOG_LEVEL_WARN, "%s%s%s%s%s%s%s%s", "0123456789", "0123456789", "0123456789", "0123456789", "0123456789", "0123456789", "0123456789", "0123456789");
+    log_record_t xRec;
+    CHECK(bQueuePop(&xLogRing, &xRec));
+    char pcLine[24];
+    memset(pcLine, '#', sizeof(pcLine));
+    size_t uiLen = uiLogFormat(&xRec, pcLine, 16);
+    CHECK_EQ(uiLen, 15);
+    CHECK_EQ(strlen(pcLine), 15);
+    CHECK_EQ(pcLine[16], '#');
+    CHECK(strstr(pcLine, " W 0123") != NULL);
+}
+
+TEST(full_ring_counts_drops) {
+    uint32_t ulDropped = xLogRing.ulDropped;
+    for (int i = 0; i < LOG_RING_SIZE + 5; i++) vLogPush(LOG_LEVEL_INFO, "%d", i);
+    CHECK_EQ(uiQueueDepth(&xLogRing), LOG_RING_SIZE - 1);
+    CHECK_EQ(xLogRing.ulDropped - ulDropped, 6);
+    log_record_t xRec;
+    while (bQueuePop(&xLogRing, &xRec)) {}
+}
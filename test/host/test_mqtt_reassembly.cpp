@@ -0,0 +1,111 @@
+#include <Arduino.h>
+#include <mqtt_reassembly.h>
+#include <string>
+#include "host_test.h"
+
+// Keys stand for routes, the reassembly only compares the pointers
+static const int iRouteA = 0, iRouteB = 0;
+static mqtt_reassembly_t xAsm;
+
+// Feeds sMessage in chunks of uiChunk bytes the way AsyncMqttClient does, counts the complete ones
+static int iFeed(const void * pvKey, const std::string & sMessage, size_t uiChunk, size_t uiFirst = 0, size_t uiLast = SIZE_MAX) {
+    int iComplete = 0;
+    size_t uiTotal = sMessage.size();
+    size_t uiIndex = uiFirst;
+    do {
+        size_t uiLen = min(uiChunk, uiTotal - uiIndex);
+        if (bReasmFeed(&xAsm, pvKey, sMessage.data() + uiIndex, uiLen, uiIndex, uiTotal)) iComplete++;
+        uiIndex += uiLen;
+    } while (uiIndex < uiTotal && uiIndex < uiLast);
+    return iComplete;
+}
+
+static std::string sPattern(size_t len) {
+    std::string s;
+    for (size_t i = 0; i < len; i++) s += (char)('a' + i % 26);
+    return s;
+}
+
+static bool bBufIs(const std::string & s) {
+    return xAsm.uiTotal == s.size() && memcmp(xAsm.pcBuf, s.data(), s.size()) == 0 && xAsm.pcBuf[s.size()] == '\0';
+}
+
+TEST(single_chunk) {
+    memset(&xAsm, 0, sizeof(xAsm));
+    CHECK_EQ(iFeed(&iRouteA, "{\"l1_state\":\"ON\"}", 1460), 1);
+    CHECK(bBufIs("{\"l1_state\":\"ON\"}"));
+    CHECK_EQ(xAsm.ulChunked, 0);
+}
+
+TEST(in_order_chunks) {
+    memset(&xAsm, 0, sizeof(xAsm));
+    for (size_t uiChunk : { 1, 7, 100, 333, 1023 }) {
+        std::string s = sPattern(MQTT_MESSAGE_MAX_LEN);
+        CHECK_EQ(iFeed(&iRouteA, s, uiChunk), 1);
+        CHECK(bBufIs(s));
+    }
+    CHECK_EQ(xAsm.ulChunked, 5);
+    CHECK_EQ(xAsm.ulAborted, 0);
+}
+
+TEST(zero_length_payload) {
+    memset(&xAsm, 0, sizeof(xAsm));
+    CHECK(bReasmFeed(&xAsm, &iRouteA, "", 0, 0, 0));
+    CHECK(bBufIs(""));
+    CHECK_EQ(xAsm.ulAborted, 0);
+    CHECK_EQ(iFeed(&iRouteA, "next", 2), 1);    // nothing left over from it
+    CHECK(bBufIs("next"));
+}
+
+// A new message while one is half in: the half one is gone, the new one comes through
+TEST(new_message_aborts_a_partial_one) {
+    memset(&xAsm, 0, sizeof(xAsm));
+    std::string sFirst = sPattern(600), sSecond = "{\"l2_state\":\"OFF\"}";
+    CHECK_EQ(iFeed(&iRouteA, sFirst, 200, 0, 400), 0);
+    CHECK_EQ(iFeed(&iRouteB, sSecond, 5), 1);
+    CHECK(bBufIs(sSecond));
+    CHECK_EQ(xAsm.ulAborted, 1);
+    // the rest of the aborted message is not glued to anything
+    CHECK_EQ(iFeed(&iRouteA, sFirst, 200, 400), 0);
+    CHECK(bBufIs(sSecond));
+    CHECK_EQ(iFeed(&iRouteA, sFirst, 200), 1);
+    CHECK(bBufIs(sFirst));
+}
+
+// Chunks that do not continue the message in progress: another route, a gap, another total
+TEST(chunk_out_of_line_aborts) {
+    memset(&xAsm, 0, sizeof(xAsm));
+    std::string s = sPattern(300);
+    CHECK(!bReasmFeed(&xAsm, &iRouteA, s.data(), 100, 0, 300));
+    CHECK(!bReasmFeed(&xAsm, &iRouteB, s.data() + 100, 100, 100, 300));
+    CHECK_EQ(xAsm.ulAborted, 1);
+    CHECK(!bReasmFeed(&xAsm, &iRouteA, s.data() + 200, 100, 200, 300));
+    CHECK_EQ(xAsm.ulAborted, 1);
+
+    CHECK(!bReasmFeed(&xAsm, &iRouteA, s.data(), 100, 0, 300));
+    CHECK(!bReasmFeed(&xAsm, &iRouteA, s.data() + 200, 100, 200, 300));     // 100..200 missing
+    CHECK_EQ(xAsm.ulAborted, 2);
+
+    CHECK(!bReasmFeed(&xAsm, &iRouteA, s.data(), 100, 0, 300));
+    CHECK(!bReasmFeed(&xAsm, &iRouteA, s.data() + 100, 100, 100, 250));
+    CHECK_EQ(xAsm.ulAborted, 3);
+}
+
+// Longer than MQTT_MESSAGE_MAX_LEN: refused whole, never a truncated prefix
+TEST(oversize_is_skipped_not_truncated) {
+    memset(&xAsm, 0, sizeof(xAsm));
+    std::string sBig = sPattern(MQTT_MESSAGE_MAX_LEN + 1);
+    CHECK_EQ(iFeed(&iRouteA, sBig, 100), 0);
+    CHECK_EQ(xAsm.ulOversized, 1);
+    CHECK(!xAsm.bSkipping);
+    CHECK_EQ(iFeed(&iRouteA, sBig, 2000), 0);     // in one piece
+    CHECK_EQ(xAsm.ulOversized, 2);
+    CHECK_EQ(iFeed(&iRouteA, "{}", 1), 1);
+    CHECK(bBufIs("{}"));
+    CHECK_EQ(xAsm.ulAborted, 0);
+
+    CHECK_EQ(iFeed(&iRouteA, sBig, 100, 0, 500), 0);      // cut off by the next message
+    CHECK(xAsm.bSkipping);
+    CHECK_EQ(iFeed(&iRouteB, "{}", 1), 1);
+    CHECK_EQ(xAsm.ulAborted, 1);
+}
@@ -0,0 +1,112 @@
+#include <Arduino.h>
+#include <report_journal.h>
+#include "host_test.h"
+
+static journal_t xJournal;
+static char pcBuf[JOURNAL_REPORT_LEN];
+
+static void vStart() {
+    memset(pcHostRtc, 0, sizeof(pcHostRtc));    // no journal from a previous run
+    vJournalBegin(&xJournal);
+}
+
+static void vAppend(uint16_t uiCount) {
+    for (uint16_t i = 0; i < uiCount; i++) vJournalAppend(&xJournal, JE_RELAYS, i, 1000 + i, false);
+}
+
+static uint16_t uiOldestSeq() {
+    return xJournal.xEvents[xJournal.xHeader.uiHead].uiSeq;
+}
+
+static void vReplay(uint16_t uiPacketId) {
+    CHECK(uiJournalFormat(&xJournal, pcBuf, sizeof(pcBuf)) > 0);
+    vJournalReplaySent(&xJournal, uiPacketId);
+}
+
+TEST(replay_and_ack) {
+    vStart();
+    CHECK_EQ(uiJournalFormat(&xJournal, pcBuf, sizeof(pcBuf)), 0);
+    vAppend(2);
+    vReplay(7);
+    CHECK(strcmp(pcBuf, "{\"journal\":[[0,1,0,1000,0],[1,1,1,1001,0]],\"lost\":0}") == 0);
+    CHECK(!bJournalAck(&xJournal, 8));
+    CHECK(bJournalAck(&xJournal, 7));
+    CHECK(!bJournalAck(&xJournal, 7));
+    CHECK_EQ(xJournal.xHeader.uiCount, 0);
+    CHECK_EQ(uiJournalFormat(&xJournal, pcBuf, sizeof(pcBuf)), 0);
+}
+
+TEST(events_added_in_flight_stay) {
+    vStart();
+    vAppend(5);
+    vReplay(7);
+    vAppend(3);
+    CHECK(bJournalAck(&xJournal, 7));
+    CHECK_EQ(xJournal.xHeader.uiCount, 3);
+    CHECK_EQ(uiOldestSeq(), 5);
+}
+
+// The ring overflowed while the replay was in flight: the head moved past replayed events,
+// the ack must drop only the replayed ones that are left
+TEST(overflow_in_flight_drops_only_replayed_events) {
+    vStart();
+    vAppend(5);                         // seq 0..4
+    vReplay(7);
+    vAppend(JOURNAL_SIZE - 5 + 2);      // seq 5..25, 0 and 1 overwritten
+    CHECK_EQ(uiOldestSeq(), 2);
+    CHECK_EQ(xJournal.xHeader.uiLost, 0);       // they went out with the replay
+    CHECK(bJournalAck(&xJournal, 7));
+    CHECK_EQ(xJournal.xHeader.uiCount, JOURNAL_SIZE - 3);
+    CHECK_EQ(uiOldestSeq(), 5);
+    CHECK_EQ(xJournal.xHeader.uiLost, 0);
+}
+
+TEST(overflow_past_the_replay_counts_lost) {
+    vStart();
+    vAppend(JOURNAL_SIZE);              // seq 0..23
+    vReplay(7);
+    vAppend(JOURNAL_SIZE + 6);          // every replayed event and 6 new ones overwritten
+    CHECK_EQ(xJournal.xHeader.uiLost, 6);
+    CHECK(bJournalAck(&xJournal, 7));
+    CHECK_EQ(xJournal.xHeader.uiCount, JOURNAL_SIZE);
+    CHECK_EQ(uiOldestSeq(), JOURNAL_SIZE + 6);
+    CHECK_EQ(xJournal.xHeader.uiLost, 6);       // not reported yet
+    vReplay(8);
+    CHECK(strstr(pcBuf, "\"lost\":6}") != NULL);
+    CHECK(bJournalAck(&xJournal, 8));
+    CHECK_EQ(xJournal.xHeader.uiLost, 0);
+}
+
+TEST(lost_before_the_replay_is_cleared_by_its_ack) {
+    vStart();
+    vAppend(JOURNAL_SIZE + 4);          // offline, 4 lost
+    vReplay(7);
+    CHECK(strstr(pcBuf, "\"lost\":4}") != NULL);
+    CHECK(bJournalAck(&xJournal, 7));
+    CHECK_EQ(xJournal.xHeader.uiLost, 0);
+    CHECK_EQ(xJournal.xHeader.uiCount, 0);
+}
+
+// No PUBACK before the disconnect: the replay is repeated in full on the next connect
+TEST(unacked_replay_is_repeated) {
+    vStart();
+    vAppend(3);
+    vReplay(7);
+    xJournal.uiReplayPacketId = 0;      // what the sketch does on disconnect
+    vAppend(JOURNAL_SIZE - 1);          // now the overwritten ones are lost
+    CHECK_EQ(xJournal.xHeader.uiLost, 2);
+    vReplay(9);
+    CHECK(bJournalAck(&xJournal, 9));
+    CHECK_EQ(xJournal.xHeader.uiCount, 0);
+    CHECK_EQ(xJournal.xHeader.uiLost, 0);
+}
+
+TEST(survives_a_reset_in_rtc) {
+    vStart();
+    vAppend(4);
+    journal_t xAfterReset;
+    vJournalBegin(&xAfterReset);
+    CHECK_EQ(xAfterReset.xHeader.uiCount, 4);
+    CHECK_EQ(xAfterReset.xHeader.uiNextSeq, 4);
+    CHECK_EQ(xAfterReset.xEvents[3].uiData, 3);
+}
@@ -0,0 +1,92 @@
+#include <Arduino.h>
+#include <report_scheduler.h>
+#include "host_test.h"
+
+static report_scheduler_t xNew() {
+    report_scheduler_t xSched;
+    memset(&xSched, 0, sizeof(xSched));
+    return xSched;
+}
+
+TEST(first_report_goes_at_once_then_coalesces) {
+    report_scheduler_t xSched = xNew();
+    CHECK(bReportSchedReady(&xSched, 1000));
+    vReportSchedSent(&xSched, 1, 0x1, 0x1, 1000);
+    CHECK(!bReportSchedReady(&xSched, 1000 + REPORT_COALESCE_MS - 1));
+    CHECK(bReportSchedReady(&xSched, 1000 + REPORT_COALESCE_MS));
+}
+
+TEST(inflight_window_is_bounded) {
+    report_scheduler_t xSched = xNew();
+    uint32_t ulNow = 0;
+    for (uint16_t i = 1; i <= REPORT_MAX_INFLIGHT; i++) {
+        ulNow += REPORT_COALESCE_MS;
+        CHECK(bReportSchedReady(&xSched, ulNow));
+        vReportSchedSent(&xSched, i, 0x1, i & 1, ulNow);
+    }
+    ulNow += REPORT_COALESCE_MS;
+    CHECK(!bReportSchedReady(&xSched, ulNow));
+    uint32_t ulSentAt = 0;
+    CHECK(bReportSchedAck(&xSched, 2, &ulSentAt));
+    CHECK_EQ(ulSentAt, 2 * REPORT_COALESCE_MS);
+    CHECK(bReportSchedReady(&xSched, ulNow));
+    CHECK(!bReportSchedAck(&xSched, 2, &ulSentAt));     // not twice
+    CHECK(!bReportSchedAck(&xSched, 99, &ulSentAt));    // not a state report
+}
+
+TEST(delta_is_against_newest_sent_state) {
+    // ON is in flight, the relay goes OFF and back ON before any PUBACK.
+    // Each change must be reported, the unchanged state must not.
+    report_scheduler_t xSched = xNew();
+    CHECK(!bReportSchedKnown(&xSched, 0, true));
+    vReportSchedSent(&xSched, 1, 0x1, 0x1, 0);
+    CHECK(bReportSchedKnown(&xSched, 0, true));
+    CHECK(!bReportSchedKnown(&xSched, 0, false));
+    vReportSchedSent(&xSched, 2, 0x1, 0x0, 300);
+    CHECK(bReportSchedKnown(&xSched, 0, false));
+    CHECK(!bReportSchedKnown(&xSched, 0, true));    // ON again differs from the OFF in flight
+    uint32_t ulSentAt = 0;
+    CHECK(bReportSchedAck(&xSched, 1, &ulSentAt));  // a late PUBACK of the old ON changes nothing
+    CHECK(bReportSchedKnown(&xSched, 0, false));
+    CHECK(!bReportSchedKnown(&xSched, 0, true));
+}
+
+TEST(relays_outside_the_mask_keep_their_state) {
+    report_scheduler_t xSched = xNew();
+    vReportSchedSent(&xSched, 1, 0x3, 0x3, 0);
+    vReportSchedSent(&xSched, 2, 0x2, 0x0, 300);
+    CHECK(bReportSchedKnown(&xSched, 0, true));
+    CHECK(bReportSchedKnown(&xSched, 1, false));
+    CHECK(!bReportSchedKnown(&xSched, 2, false));
+}
+
+TEST(timeout_makes_relays_unknown) {
+    report_scheduler_t xSched = xNew();
+    vReportSchedSent(&xSched, 1, 0x1, 0x1, 0);
+    CHECK(bReportSchedReady(&xSched, REPORT_ACK_TIMEOUT_MS - 1));
+    CHECK_EQ(xSched.uiInflight, 1);
+    CHECK(bReportSchedReady(&xSched, REPORT_ACK_TIMEOUT_MS));
+    CHECK_EQ(xSched.uiInflight, 0);
+    CHECK_EQ(xSched.ulAckTimeouts, 1);
+    CHECK(!bReportSchedKnown(&xSched, 0, true));
+}
+
+TEST(reset_falls_back_to_acknowledged_state) {
+    report_scheduler_t xSched = xNew();
+    uint32_t ulSentAt = 0;
+    vReportSchedSent(&xSched, 1, 0x1, 0x1, 0);
+    CHECK(bReportSchedAck(&xSched, 1, &ulSentAt));
+    vReportSchedSent(&xSched, 2, 0x3, 0x2, 300);    // relay 0 OFF, relay 1 ON, never acknowledged
+    vReportSchedReset(&xSched);
+    CHECK_EQ(xSched.uiInflight, 0);
+    CHECK(bReportSchedKnown(&xSched, 0, true));
+    CHECK(!bReportSchedKnown(&xSched, 0, false));
+    CHECK(!bReportSchedKnown(&xSched, 1, true));
+}
+
+TEST(failed_publish_records_nothing) {
+    report_scheduler_t xSched = xNew();
+    vReportSchedSent(&xSched, 0, 0x1, 0x1, 0);
+    CHECK_EQ(xSched.uiInflight, 0);
+    CHECK(!bReportSchedKnown(&xSched, 0, true));
+}
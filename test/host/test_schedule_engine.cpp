@@ -0,0 +1,147 @@
+#include <Arduino.h>
+#include <schedule_engine.h>
+#include <string>
+#include "host_test.h"
+
+// Local midnights, see TimeLib: dayOfWeek() 1 = Sunday
+#define SAT_2024_01_06  ((time_t)1704499200)
+#define SUN_2024_01_07  ((time_t)1704585600)
+#define MON_2024_01_08  ((time_t)1704672000)
+#define WED_2024_01_10  ((time_t)1704844800)
+#define AT(day, h, m)   ((day) + (h) * SECS_PER_HOUR + (m) * SECS_PER_MIN)
+
+static schedule_t xSched;
+
+static uint8_t uiParse(const char * pc, uint8_t uiChannels = 3) {
+    return uiScheduleParse(&xSched.xTable, pc, strlen(pc), uiChannels);
+}
+
+static time_t tNext(const char * pcTable, time_t tNow) {
+    memset(&xSched, 0, sizeof(xSched));
+    if (uiParse(pcTable) != 0) return (time_t)-1;
+    return tScheduleNext(&xSched, tNow);
+}
+
+TEST(fixed_days_are_what_the_test_says) {
+    CHECK_EQ(dayOfWeek(SAT_2024_01_06), 7);
+    CHECK_EQ(dayOfWeek(SUN_2024_01_07), 1);
+    CHECK_EQ(dayOfWeek(MON_2024_01_08), 2);
+    CHECK_EQ(dayOfWeek(WED_2024_01_10), 4);
+}
+
+// 1 = Monday .. 7 = Sunday in the text, TimeLib counts from Sunday
+TEST(weekday_mapping) {
+    CHECK_EQ(tNext("08:00 1 1 ON", AT(SUN_2024_01_07, 12, 0)), AT(MON_2024_01_08, 8, 0));
+    CHECK_EQ(xSched.uiNextDay, 0);
+    CHECK_EQ(tNext("08:00 7 1 ON", AT(SAT_2024_01_06, 12, 0)), AT(SUN_2024_01_07, 8, 0));
+    CHECK_EQ(xSched.uiNextDay, 6);
+    CHECK_EQ(tNext("08:00 7 1 ON", AT(SUN_2024_01_07, 7, 59)), AT(SUN_2024_01_07, 8, 0));
+    CHECK_EQ(tNext("08:00 3 1 ON", AT(MON_2024_01_08, 9, 0)), AT(WED_2024_01_10, 8, 0));
+}
+
+TEST(sunday_to_monday_boundary) {
+    CHECK_EQ(tNext("00:00 1 1 ON", AT(SUN_2024_01_07, 23, 59)), MON_2024_01_08);
+    CHECK_EQ(tNext("23:59 7 1 ON", AT(SUN_2024_01_07, 23, 58)), AT(SUN_2024_01_07, 23, 59));
+    CHECK_EQ(tNext("23:59 7 1 ON", AT(SUN_2024_01_07, 23, 59)), AT(SUN_2024_01_07, 23, 59) + 7 * SECS_PER_DAY);
+    CHECK_EQ(tNext("00:00 7 1 ON", AT(MON_2024_01_08, 0, 0)), AT(SUN_2024_01_07, 0, 0) + 7 * SECS_PER_DAY);
+}
+
+// The minute that is running now has fired already or is firing
+TEST(same_minute_is_skipped) {
+    CHECK_EQ(tNext("10:00 * 1 ON", AT(WED_2024_01_10, 10, 0)), AT(WED_2024_01_10, 10, 0) + SECS_PER_DAY);
+    CHECK_EQ(tNext("10:00 * 1 ON", AT(WED_2024_01_10, 10, 0) + 59), AT(WED_2024_01_10, 10, 0) + SECS_PER_DAY);
+    CHECK_EQ(tNext("10:00 * 1 ON", AT(WED_2024_01_10, 9, 59) + 59), AT(WED_2024_01_10, 10, 0));
+}
+
+// Only today's day is set and its time has passed: a week ahead, not never
+TEST(single_day_passed_today_wraps_to_next_week) {
+    CHECK_EQ(tNext("09:00 3 1 ON", AT(WED_2024_01_10, 10, 0)), AT(WED_2024_01_10, 9, 0) + 7 * SECS_PER_DAY);
+    CHECK_EQ(xSched.uiNextDay, 2);
+    CHECK_EQ(tNext("", AT(WED_2024_01_10, 10, 0)), 0);
+}
+
+TEST(earliest_matching_entry_wins) {
+    CHECK_EQ(tNext("20:00 * 2 OFF;07:00 * 1 ON;12:00 12345 3 TOGGLE", AT(SAT_2024_01_06, 8, 0)), AT(SAT_2024_01_06, 20, 0));
+    CHECK_EQ(tNext("20:00 * 2 OFF;07:00 * 1 ON;12:00 12345 3 TOGGLE", AT(SAT_2024_01_06, 21, 0)), AT(SUN_2024_01_07, 7, 0));
+    CHECK_EQ(tNext("20:00 * 2 OFF;07:00 * 1 ON;12:00 12345 3 TOGGLE", AT(MON_2024_01_08, 8, 0)), AT(MON_2024_01_08, 12, 0));
+}
+
+TEST(sorted_by_minute_and_stable) {
+    CHECK_EQ(uiParse("20:00 * 1 ON;07:00 * 2 ON;20:00 * 3 OFF;07:00 * 1 OFF\n06:59 * 3 TOGGLE"), 0);
+    const schedule_table_t * pxTable = &xSched.xTable;
+    CHECK_EQ(pxTable->uiCount, 5);
+    const uint16_t uiMinutes[] = { 6 * 60 + 59, 7 * 60, 7 * 60, 20 * 60, 20 * 60 };
+    const uint8_t uiChannels[] = { 2, 1, 0, 0, 2 };
+    const uint8_t uiCommands[] = { SCHED_CMD_TOGGLE, SCHED_CMD_ON, SCHED_CMD_OFF, SCHED_CMD_ON, SCHED_CMD_OFF };
+    for (uint8_t i = 0; i < 5; i++) {
+        CHECK_EQ(pxTable->xEntries[i].uiMinute, uiMinutes[i]);
+        CHECK_EQ(uiSchedChannel(&pxTable->xEntries[i]), uiChannels[i]);
+        CHECK_EQ(uiSchedCommand(&pxTable->xEntries[i]), uiCommands[i]);
+    }
+}
+
+// Every entry of the deadline's minute and day fires, the others do not
+TEST(entries_due_at_the_deadline) {
+    CHECK_EQ(tNext("07:00 1 1 ON;07:00 2 2 ON;07:00 * 3 ON;07:01 * 1 OFF", AT(SUN_2024_01_07, 8, 0)), AT(MON_2024_01_08, 7, 0));
+    CHECK(bScheduleEntryDue(&xSched, &xSched.xTable.xEntries[0]));
+    CHECK(!bScheduleEntryDue(&xSched, &xSched.xTable.xEntries[1]));
+    CHECK(bScheduleEntryDue(&xSched, &xSched.xTable.xEntries[2]));
+    CHECK(!bScheduleEntryDue(&xSched, &xSched.xTable.xEntries[3]));
+}
+
+TEST(parse_fields) {
+    CHECK_EQ(uiParse(" 23:59  1357  3  toggle ;; \n"), 0);
+    CHECK_EQ(xSched.xTable.uiCount, 1);
+    const sched_entry_t * pxEntry = &xSched.xTable.xEntries[0];
+    CHECK_EQ(pxEntry->uiMinute, 23 * 60 + 59);
+    CHECK_EQ(pxEntry->uiDays, 0x55);
+    CHECK_EQ(uiSchedChannel(pxEntry), 2);
+    CHECK_EQ(uiSchedCommand(pxEntry), SCHED_CMD_TOGGLE);
+    CHECK_EQ(uiParse("00:00 * 1 OFF"), 0);
+    CHECK_EQ(xSched.xTable.xEntries[0].uiDays, SCHED_EVERY_DAY);
+    CHECK_EQ(uiParse(""), 0);
+    CHECK_EQ(xSched.xTable.uiCount, 0);
+}
+
+// The number of the first bad entry comes back
+TEST(parse_errors) {
+    CHECK_EQ(uiParse("24:00 * 1 ON"), 1);
+    CHECK_EQ(uiParse("12:60 * 1 ON"), 1);
+    CHECK_EQ(uiParse("7:00 * 1 ON"), 1);
+    CHECK_EQ(uiParse("07-00 * 1 ON"), 1);
+    CHECK_EQ(uiParse("07:00 8 1 ON"), 1);
+    CHECK_EQ(uiParse("07:00 0 1 ON"), 1);
+    CHECK_EQ(uiParse("07:00 1* 1 ON"), 1);
+    CHECK_EQ(uiParse("07:00 * 0 ON"), 1);
+    CHECK_EQ(uiParse("07:00 * 4 ON"), 1);
+    CHECK_EQ(uiParse("07:00 * 4 ON", 4), 0);
+    CHECK_EQ(uiParse("07:00 * 100 ON", 16), 1);
+    CHECK_EQ(uiParse("07:00 * 1 DIM"), 1);
+    CHECK_EQ(uiParse("07:00 * 1"), 1);
+    CHECK_EQ(uiParse("07:00 * 1 ON now"), 1);
+    CHECK_EQ(uiParse("07:00 * 1 ON;08:00 * 1 OFF 5"), 2);
+    CHECK_EQ(uiParse("07:00 * 1 ON;;08:00 * 1 OF"), 3);     // blank entries count
+}
+
+TEST(too_many_entries) {
+    std::string sTable;
+    for (int i = 0; i < SCHED_MAX_ENTRIES; i++) sTable += "07:00 * 1 ON;";
+    CHECK_EQ(uiParse(sTable.c_str()), 0);
+    CHECK_EQ(xSched.xTable.uiCount, SCHED_MAX_ENTRIES);
+    sTable += "08:00 * 1 ON";
+    CHECK_EQ(uiParse(sTable.c_str()), SCHED_MAX_ENTRIES + 1);
+}
+
+TEST(stored_table_is_checked) {
+    CHECK_EQ(uiParse("07:00 * 1 ON;08:00 * 2 OFF"), 0);
+    vScheduleSeal(&xSched);
+    schedule_table_t xStored = xSched.xTable;
+    schedule_t xLoaded;
+    vScheduleBegin(&xLoaded, &xStored);
+    CHECK_EQ(xLoaded.xTable.uiCount, 2);
+    xStored.xEntries[1].uiMinute++;
+    vScheduleBegin(&xLoaded, &xStored);
+    CHECK_EQ(xLoaded.xTable.uiCount, 0);
+    vScheduleBegin(&xLoaded, NULL);
+    CHECK_EQ(xLoaded.xTable.uiCount, 0);
+}
@@ -0,0 +1,60 @@
+#include <Arduino.h>
+#include <spsc_queue.h>
+#include "host_test.h"
+
+TEST(fifo_order) {
+    spsc_queue_t<uint32_t, 8> xQueue = {};
+    for (uint32_t i = 1; i <= 5; i++) CHECK(bQueuePush(&xQueue, &i));
+    CHECK_EQ(uiQueueDepth(&xQueue), 5);
+    uint32_t ul = 0;
+    for (uint32_t i = 1; i <= 5; i++) {
+        CHECK(bQueuePop(&xQueue, &ul));
+        CHECK_EQ(ul, i);
+    }
+    CHECK(!bQueuePop(&xQueue, &ul));
+    CHECK_EQ(uiQueueDepth(&xQueue), 0);
+}
+
+TEST(one_slot_kept_free) {
+    spsc_queue_t<uint32_t, 4> xQueue = {};
+    uint32_t ul = 7;
+    CHECK(bQueuePush(&xQueue, &ul));
+    CHECK(bQueuePush(&xQueue, &ul));
+    CHECK(bQueuePush(&xQueue, &ul));
+    CHECK(!bQueuePush(&xQueue, &ul));
+    CHECK(!bQueuePush(&xQueue, &ul));
+    CHECK_EQ(uiQueueDepth(&xQueue), 3);
+    CHECK_EQ(xQueue.uiDepthMax, 3);
+    CHECK_EQ(xQueue.ulDropped, 2);
+}
+
+TEST(wraps_around) {
+    spsc_queue_t<uint16_t, 4> xQueue = {};
+    uint16_t uiIn = 0, uiOut = 0, ui;
+    for (int n = 0; n < 1000; n++) {
+        uint8_t uiPush = 1 + n % 3;
+        for (uint8_t i = 0; i < uiPush; i++) {
+            if (bQueuePush(&xQueue, &uiIn)) uiIn++;
+        }
+        while (bQueuePop(&xQueue, &ui)) {
+            CHECK_EQ(ui, uiOut);
+            uiOut++;
+        }
+    }
+    CHECK_EQ(uiIn, uiOut);
+    CHECK_EQ(xQueue.ulDropped, 0);
+}
+
+TEST(struct_items_are_copied) {
+    typedef struct {
+        uint8_t pc[12];
+        uint32_t ul = 0;
+    } item_t;
+    spsc_queue_t<item_t, 2> xQueue = {};
+    item_t xIn = { "hello", 42 }, xOut = {};
+    CHECK(bQueuePush(&xQueue, &xIn));
+    xIn.ul = 0;
+    CHECK(bQueuePop(&xQueue, &xOut));
+    CHECK_EQ(xOut.ul, 42);
+    CHECK(strcmp((const char *)xOut.pc, "hello") == 0);
+}
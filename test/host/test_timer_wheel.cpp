@@ -0,0 +1,171 @@
+#include <Arduino.h>
+#include <timer_wheel.h>
+#include "host_test.h"
+
+#define TIMERS  64
+
+static wheel_timer_t xTimers[TIMERS];
+static uint32_t ulFiredAtTick[TIMERS];
+static uint32_t ulFireCount[TIMERS];
+
+static void vRecordCB(uint32_t ulArg) {
+    ulFiredAtTick[ulArg] = xTimerWheel.ulTicks;
+    ulFireCount[ulArg]++;
+}
+
+static void vReset() {
+    ullHostMicros = 0;
+    memset(xTimers, 0, sizeof(xTimers));
+    memset(ulFiredAtTick, 0, sizeof(ulFiredAtTick));
+    memset(ulFireCount, 0, sizeof(ulFireCount));
+    vTimerWheelBegin(&xTimerWheel);
+}
+
+// Runs the wheel up to ulMs from now in ulStepMs steps
+static void vRunFor(uint32_t ulMs, uint32_t ulStepMs) {
+    for (uint32_t ul = 0; ul < ulMs; ul += ulStepMs) {
+        vHostAdvanceMs(ulStepMs);
+        vTimerWheelRun(&xTimerWheel);
+    }
+}
+
+TEST(fires_on_its_tick_at_every_level) {
+    vReset();
+    // Delays across all four levels and the cascade edges between them
+    const uint32_t ulDelays[] = { 0, 1, 10, 11, 300, 310, 320, 330, 10230, 10240, 10250, 327670, 327680, 327690,
+                                  1000000, 10485750, 10485760, 10485770 };
+    const uint8_t uiCount = sizeof(ulDelays) / sizeof(ulDelays[0]);
+    for (uint8_t i = 0; i < uiCount; i++) vTimerArm(&xTimerWheel, &xTimers[i], ulDelays[i], vRecordCB, i);
+    vRunFor(10485770 + 1000, 1000);
+    for (uint8_t i = 0; i < uiCount; i++) {
+        uint32_t ulTicks = (ulDelays[i] + TW_TICK_MS - 1) / TW_TICK_MS;
+        CHECK_EQ(ulFireCount[i], 1);
+        CHECK_EQ(ulFiredAtTick[i], ulTicks ? ulTicks : 1);
+        CHECK(!bTimerArmed(&xTimers[i]));
+    }
+}
+
+TEST(random_delays_and_arm_times) {
+    vReset();
+    std::mt19937 xRng(7);
+    uint32_t ulExpected[TIMERS];
+    for (uint8_t i = 0; i < TIMERS; i++) {
+        vRunFor(TW_TICK_MS * (xRng() % 50), TW_TICK_MS);
+        uint32_t ulDelay = xRng() % 400000;
+        vTimerArm(&xTimerWheel, &xTimers[i], ulDelay, vRecordCB, i);
+        uint32_t ulTicks = (ulDelay + TW_TICK_MS - 1) / TW_TICK_MS;
+        ulExpected[i] = xTimerWheel.ulTicks + (ulTicks ? ulTicks : 1);
+    }
+    vRunFor(500000, 70);
+    for (uint8_t i = 0; i < TIMERS; i++) {
+        CHECK_EQ(ulFireCount[i], 1);
+        CHECK_EQ(ulFiredAtTick[i], ulExpected[i]);
+    }
+}
+
+TEST(longer_than_the_wheel) {
+    vReset();
+    const uint32_t ulDelay = 4UL * 3600 * 1000;     // the wheel holds about 2.9 hours
+    vTimerArm(&xTimerWheel, &xTimers[0], ulDelay, vRecordCB, 0);
+    vRunFor(ulDelay - 1000, 1000);
+    CHECK_EQ(ulFireCount[0], 0);
+    vRunFor(2000, 10);
+    CHECK_EQ(ulFireCount[0], 1);
+    CHECK_EQ(ulFiredAtTick[0], ulDelay / TW_TICK_MS);
+}
+
+TEST(cancel_and_rearm) {
+    vReset();
+    vTimerArm(&xTimerWheel, &xTimers[0], 100, vRecordCB, 0);
+    vTimerArm(&xTimerWheel, &xTimers[1], 100, vRecordCB, 1);
+    vTimerArm(&xTimerWheel, &xTimers[2], 100, vRecordCB, 2);
+    vTimerCancel(&xTimers[1]);
+    vTimerCancel(&xTimers[1]);      // twice is fine
+    vTimerArm(&xTimerWheel, &xTimers[2], 5000, vRecordCB, 2);   // rearm moves it
+    vRunFor(1000, 10);
+    CHECK_EQ(ulFireCount[0], 1);
+    CHECK_EQ(ulFireCount[1], 0);
+    CHECK_EQ(ulFireCount[2], 0);
+    vRunFor(5000, 10);
+    CHECK_EQ(ulFireCount[2], 1);
+    CHECK_EQ(ulFiredAtTick[2], 500);
+}
+
+TEST(periodic) {
+    vReset();
+    vTimerArm(&xTimerWheel, &xTimers[0], 100, vRecordCB, 0, 250);
+    vRunFor(100 + 250 * 10, 10);
+    CHECK_EQ(ulFireCount[0], 11);
+    CHECK(bTimerArmed(&xTimers[0]));
+    vRunFor(100000, 250);           // late loop() passes do not lose periods
+    CHECK_EQ(ulFireCount[0], 11 + 400);
+    vTimerCancel(&xTimers[0]);
+    vRunFor(1000, 10);
+    CHECK_EQ(ulFireCount[0], 411);
+}
+
+static void vCancelOtherCB(uint32_t ulArg) {
+    vRecordCB(ulArg);
+    vTimerCancel(&xTimers[ulArg + 1]);
+    vTimerArm(&xTimerWheel, &xTimers[ulArg], 0, vRecordCB, ulArg);     // same slot list, next tick
+}
+
+TEST(callbacks_may_change_their_own_slot) {
+    vReset();
+    vTimerArm(&xTimerWheel, &xTimers[1], 50, vRecordCB, 1);
+    vTimerArm(&xTimerWheel, &xTimers[2], 50, vRecordCB, 2);
+    vTimerArm(&xTimerWheel, &xTimers[0], 50, vCancelOtherCB, 0);     // last armed runs first
+    vRunFor(200, 10);
+    CHECK_EQ(ulFireCount[0], 2);
+    CHECK_EQ(ulFiredAtTick[0], 6);
+    CHECK_EQ(ulFireCount[2], 1);
+    CHECK_EQ(ulFireCount[1], 0);
+}
+
+TEST(lag_is_recorded) {
+    vReset();
+    vRunFor(10, 10);
+    CHECK_EQ(xTimerWheel.ulLagMaxMs, 0);
+    vRunFor(250, 250);
+    CHECK_EQ(xTimerWheel.ulLagMaxMs, 240);
+}
+
+TEST(next_deadline) {
+    vReset();
+    CHECK_EQ(ulTimerWheelNextMs(&xTimerWheel, 500), 500);     // nothing armed
+    vTimerArm(&xTimerWheel, &xTimers[0], 120, vRecordCB, 0);
+    CHECK_EQ(ulTimerWheelNextMs(&xTimerWheel, 500), 120);
+    CHECK_EQ(ulTimerWheelNextMs(&xTimerWheel, 50), 50);
+    vHostAdvanceMs(5);
+    CHECK_EQ(ulTimerWheelNextMs(&xTimerWheel, 500), 115);
+    vHostAdvanceMs(200);
+    CHECK_EQ(ulTimerWheelNextMs(&xTimerWheel, 500), 0);       // overdue, loop() has not been around
+    vTimerWheelRun(&xTimerWheel);
+    CHECK_EQ(ulFireCount[0], 1);
+    CHECK_EQ(ulTimerWheelNextMs(&xTimerWheel, 500), 500);
+}
+
+// Sleeping for what ulTimerWheelNextMs() allows, every timer still runs within its tick
+TEST(sleeping_to_the_next_deadline_is_never_late) {
+    vReset();
+    std::mt19937 xRng(11);
+    uint32_t ulDueMs[16], ulRanMs[16] = {};
+    for (uint8_t i = 0; i < 16; i++) {
+        uint32_t ulDelay = (i < 8) ? xRng() % 2000 : xRng() % 400000;
+        vTimerArm(&xTimerWheel, &xTimers[i], ulDelay, vRecordCB, i);
+        ulDueMs[i] = ((ulDelay + TW_TICK_MS - 1) / TW_TICK_MS) * TW_TICK_MS;
+    }
+    uint32_t ulPasses = 0;
+    while (xTimerWheel.ulFired < 16 && ulPasses++ < 100000) {
+        vHostAdvanceMs(ulTimerWheelNextMs(&xTimerWheel, 500));
+        uint32_t ulFired = xTimerWheel.ulFired;
+        vTimerWheelRun(&xTimerWheel);
+        if (xTimerWheel.ulFired == ulFired) continue;
+        for (uint8_t i = 0; i < 16; i++) {
+            if (ulFireCount[i] && !ulRanMs[i]) ulRanMs[i] = millis();
+        }
+    }
+    CHECK_EQ(xTimerWheel.ulFired, 16);
+    for (uint8_t i = 0; i < 16; i++) CHECK(ulRanMs[i] >= ulDueMs[i] && ulRanMs[i] - ulDueMs[i] < TW_TICK_MS);
+    CHECK(ulPasses < 400000 / 500 + 16 * 3 * TW_LEVELS);        // sleeps, not a busy loop
+}
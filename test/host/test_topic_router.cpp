@@ -0,0 +1,76 @@
+#include <Arduino.h>
+#include <topic_router.h>
+#include "host_test.h"
+
+static int iCalled = -1;
+
+template <int N>
+void vCB(char * pcTopic, char * pcPayload, size_t len) { iCalled = N; }
+
+constexpr topic_route_t xRoutes[] = {
+    TOPIC_ROUTE("myhome/sonoff/ping", vCB<0>),
+    TOPIC_ROUTE("myhome/sonoff/set", vCB<1>),
+    TOPIC_ROUTE("myhome/sonoff/l1/set", vCB<2>),
+    TOPIC_ROUTE("myhome/sonoff/l2/set", vCB<3>),
+    TOPIC_ROUTE("myhome/sonoff/l3/set", vCB<4>),
+    TOPIC_ROUTE("myhome/sonoff/set/schedule", vCB<5>),
+    TOPIC_ROUTE("myhome/sonoff/rtt", vCB<6>),
+};
+#define ROUTES_COUNT    (sizeof(xRoutes) / sizeof(xRoutes[0]))
+
+static_assert(ulTopicHash("") == 2166136261UL, "FNV-1a offset basis");
+static_assert(ulTopicHash("a") == 0xE40C292CUL, "FNV-1a of \"a\"");
+
+TEST(compile_time_hash_matches_runtime) {
+    for (size_t i = 0; i < ROUTES_COUNT; i++) CHECK_EQ(xRoutes[i].ulHash, ulTopicHashRuntime(xRoutes[i].pcTopic));
+}
+
+TEST(every_route_is_found) {
+    topic_router_t xRouter;
+    CHECK(bRouterBegin(&xRouter, xRoutes, ROUTES_COUNT));
+    for (size_t i = 0; i < ROUTES_COUNT; i++) {
+        const topic_route_t * pxRoute = pxRouterFind(&xRouter, xRoutes[i].pcTopic);
+        CHECK(pxRoute == &xRoutes[i]);
+        iCalled = -1;
+        if (pxRoute) pxRoute->pvCB(NULL, NULL, 0);
+        CHECK_EQ(iCalled, (int)i);
+    }
+}
+
+TEST(unknown_topics) {
+    topic_router_t xRouter;
+    CHECK(bRouterBegin(&xRouter, xRoutes, ROUTES_COUNT));
+    CHECK(pxRouterFind(&xRouter, "myhome/sonoff") == NULL);
+    CHECK(pxRouterFind(&xRouter, "myhome/sonoff/set/") == NULL);
+    CHECK(pxRouterFind(&xRouter, "") == NULL);
+}
+
+TEST(colliding_buckets_probe_on) {
+    // Same bucket for all: the index must still find each one
+    static topic_route_t xSame[4];
+    static char pcTopics[4][8];
+    uint8_t n = 0;
+    for (uint32_t i = 0; n < 4 && i < 100000; i++) {
+        char pc[8];
+        snprintf(pc, sizeof(pc), "t%u", (unsigned)i);
+        uint32_t ulHash = ulTopicHashRuntime(pc);
+        if ((ulHash & (ROUTER_BUCKETS - 1)) != 5) continue;
+        strcpy(pcTopics[n], pc);
+        xSame[n] = { ulHash, pcTopics[n], vCB<0>, NULL };
+        n++;
+    }
+    CHECK_EQ(n, 4);
+    topic_router_t xRouter;
+    CHECK(bRouterBegin(&xRouter, xSame, 4));
+    for (uint8_t i = 0; i < 4; i++) CHECK(pxRouterFind(&xRouter, pcTopics[i]) == &xSame[i]);
+}
+
+TEST(too_many_routes_are_refused) {
+    static topic_route_t xMany[ROUTER_BUCKETS];
+    for (uint8_t i = 0; i < ROUTER_BUCKETS; i++) xMany[i] = { (uint32_t)i, "x", vCB<0>, NULL };
+    topic_router_t xRouter;
+    CHECK(!bRouterBegin(&xRouter, xMany, ROUTER_BUCKETS));
+    CHECK_EQ(xRouter.uiCount, 0);
+    CHECK(pxRouterFind(&xRouter, "x") == NULL);
+    CHECK(bRouterBegin(&xRouter, xMany, ROUTER_BUCKETS - 1));
+}